@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <lz4.h>
+#include <lz4hc.h>
 #include <stdexcept>
 #include <vector>
 
@@ -37,11 +38,18 @@ namespace compression_algorithms {
  * @param in Data to compress
  * @param inSize Size of the data
  * @param bf Compressed buffer allocator
+ * @param level Zero for the fast compressor, otherwise the level of the
+ *     high compression (LZ4HC) compressor. Both produce blocks that
+ *     lz4Decompress accepts.
  * @return Size of compressed data, or zero if failed to compress
  */
 template <typename BufferFactory>
 std::size_t
-lz4Compress(void const* in, std::size_t inSize, BufferFactory&& bf)
+lz4Compress(
+    void const* in,
+    std::size_t inSize,
+    BufferFactory&& bf,
+    int level = 0)
 {
     if (inSize > UINT32_MAX)
         Throw<std::runtime_error>("lz4 compress: invalid size");
@@ -52,11 +60,18 @@ lz4Compress(void const* in, std::size_t inSize, BufferFactory&& bf)
     // data
     auto compressed = bf(outCapacity);
 
-    auto compressedSize = LZ4_compress_default(
-        reinterpret_cast<const char*>(in),
-        reinterpret_cast<char*>(compressed),
-        inSize,
-        outCapacity);
+    auto compressedSize = level > 0
+        ? LZ4_compress_HC(
+              reinterpret_cast<const char*>(in),
+              reinterpret_cast<char*>(compressed),
+              inSize,
+              outCapacity,
+              level)
+        : LZ4_compress_default(
+              reinterpret_cast<const char*>(in),
+              reinterpret_cast<char*>(compressed),
+              inSize,
+              outCapacity);
     if (compressedSize == 0)
         Throw<std::runtime_error>("lz4 compress: failed");
 
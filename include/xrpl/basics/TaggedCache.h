@@ -43,6 +43,11 @@ namespace ripple {
     If it stays in memory even after it is ejected from the cache,
     the map will track it.
 
+    The map is split into partitions, each guarded by its own lock, so
+    threads working on keys in different partitions do not contend. The
+    cache-wide mutex only guards the settings and operations that span
+    every partition.
+
     @note Callers must not modify data objects that are stored in the cache
           unless they hold their own lock over all cache operations.
 */
@@ -80,6 +85,7 @@ public:
         , m_target_size(size)
         , m_target_age(expiration)
         , m_cache_count(0)
+        , m_locks(m_cache.partitions())
         , m_hits(0)
         , m_misses(0)
     {
@@ -97,8 +103,13 @@ public:
     std::size_t
     size() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        std::size_t ret = 0;
+        for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+        {
+            std::lock_guard lock(m_locks[p].mutex);
+            ret += m_cache.map()[p].size();
+        }
+        return ret;
     }
 
     void
@@ -109,8 +120,10 @@ public:
 
         if (s > 0)
         {
-            for (auto& partition : m_cache.map())
+            for (std::size_t p = 0; p < m_cache.partitions(); ++p)
             {
+                std::lock_guard partitionLock(m_locks[p].mutex);
+                auto& partition = m_cache.map()[p];
                 partition.rehash(static_cast<std::size_t>(
                     (s + (s >> 2)) /
                         (partition.max_load_factor() * m_cache.partitions()) +
@@ -140,39 +153,35 @@ public:
     int
     getCacheSize() const
     {
-        std::lock_guard lock(m_mutex);
         return m_cache_count;
     }
 
     int
     getTrackSize() const
     {
-        std::lock_guard lock(m_mutex);
-        return m_cache.size();
+        return size();
     }
 
     float
     getHitRate()
     {
-        std::lock_guard lock(m_mutex);
-        auto const total = static_cast<float>(m_hits + m_misses);
-        return m_hits * (100.0f / std::max(1.0f, total));
+        auto const hits = m_hits.load();
+        auto const total = static_cast<float>(hits + m_misses);
+        return hits * (100.0f / std::max(1.0f, total));
     }
 
     void
     clear()
     {
         std::lock_guard lock(m_mutex);
-        m_cache.clear();
-        m_cache_count = 0;
+        clearPartitions();
     }
 
     void
     reset()
     {
         std::lock_guard lock(m_mutex);
-        m_cache.clear();
-        m_cache_count = 0;
+        clearPartitions();
         m_hits = 0;
         m_misses = 0;
     }
@@ -184,9 +193,11 @@ public:
     bool
     touch_if_exists(KeyComparable const& key)
     {
-        std::lock_guard lock(m_mutex);
-        auto const iter(m_cache.find(key));
-        if (iter == m_cache.end())
+        auto const p = m_cache.partition(key);
+        std::lock_guard lock(m_locks[p].mutex);
+        auto& partition = m_cache.map()[p];
+        auto const iter(partition.find(key));
+        if (iter == partition.end())
         {
             ++m_stats.misses;
             return false;
@@ -215,22 +226,22 @@ public:
         {
             std::lock_guard lock(m_mutex);
 
+            auto const cacheSize = size();
             if (m_target_size == 0 ||
-                (static_cast<int>(m_cache.size()) <= m_target_size))
+                (static_cast<int>(cacheSize) <= m_target_size))
             {
                 when_expire = now - m_target_age;
             }
             else
             {
-                when_expire =
-                    now - m_target_age * m_target_size / m_cache.size();
+                when_expire = now - m_target_age * m_target_size / cacheSize;
 
                 clock_type::duration const minimumAge(std::chrono::seconds(1));
                 if (when_expire > (now - minimumAge))
                     when_expire = now - minimumAge;
 
                 JLOG(m_journal.trace())
-                    << m_name << " is growing fast " << m_cache.size() << " of "
+                    << m_name << " is growing fast " << cacheSize << " of "
                     << m_target_size << " aging at "
                     << (now - when_expire).count() << " of "
                     << m_target_age.count();
@@ -246,6 +257,7 @@ public:
                     when_expire,
                     now,
                     m_cache.map()[p],
+                    m_locks[p].mutex,
                     allStuffToSweep[p],
                     allRemovals,
                     lock));
@@ -270,11 +282,13 @@ public:
     {
         // Remove from cache, if !valid, remove from map too. Returns true if
         // removed from cache
-        std::lock_guard lock(m_mutex);
+        auto const p = m_cache.partition(key);
+        std::lock_guard lock(m_locks[p].mutex);
+        auto& partition = m_cache.map()[p];
 
-        auto cit = m_cache.find(key);
+        auto cit = partition.find(key);
 
-        if (cit == m_cache.end())
+        if (cit == partition.end())
             return false;
 
         Entry& entry = cit->second;
@@ -289,7 +303,7 @@ public:
         }
 
         if (!valid || entry.isExpired())
-            m_cache.erase(cit);
+            partition.erase(cit);
 
         return ret;
     }
@@ -316,13 +330,15 @@ public:
     {
         // Return canonical value, store if needed, refresh in cache
         // Return values: true=we had the data already
-        std::lock_guard lock(m_mutex);
+        auto const p = m_cache.partition(key);
+        std::lock_guard lock(m_locks[p].mutex);
+        auto& partition = m_cache.map()[p];
 
-        auto cit = m_cache.find(key);
+        auto cit = partition.find(key);
 
-        if (cit == m_cache.end())
+        if (cit == partition.end())
         {
-            m_cache.emplace(
+            partition.emplace(
                 std::piecewise_construct,
                 std::forward_as_tuple(key),
                 std::forward_as_tuple(m_clock.now(), data));
@@ -395,8 +411,7 @@ public:
     std::shared_ptr<T>
     fetch(const key_type& key)
     {
-        std::lock_guard<mutex_type> l(m_mutex);
-        auto ret = initialFetch(key, l);
+        auto ret = initialFetch(key);
         if (!ret)
             ++m_misses;
         return ret;
@@ -419,9 +434,10 @@ public:
     auto
     insert(key_type const& key) -> std::enable_if_t<IsKeyCache, ReturnType>
     {
-        std::lock_guard lock(m_mutex);
+        auto const p = m_cache.partition(key);
+        std::lock_guard lock(m_locks[p].mutex);
         clock_type::time_point const now(m_clock.now());
-        auto [it, inserted] = m_cache.emplace(
+        auto [it, inserted] = m_cache.map()[p].emplace(
             std::piecewise_construct,
             std::forward_as_tuple(key),
             std::forward_as_tuple(now));
@@ -448,6 +464,13 @@ public:
         return true;
     }
 
+    /** Return the cache-wide mutex.
+
+        Holding it does not stop other threads from using the cache; it
+        only excludes sweep, clear and the other cache-wide operations.
+        Owners can use it to guard state they keep alongside the cache, as
+        long as every access to that state holds it.
+    */
     mutex_type&
     peekMutex()
     {
@@ -459,10 +482,10 @@ public:
     {
         std::vector<key_type> v;
 
+        for (std::size_t p = 0; p < m_cache.partitions(); ++p)
         {
-            std::lock_guard lock(m_mutex);
-            v.reserve(m_cache.size());
-            for (auto const& _ : m_cache)
+            std::lock_guard lock(m_locks[p].mutex);
+            for (auto const& _ : m_cache.map()[p])
                 v.push_back(_.first);
         }
 
@@ -474,11 +497,11 @@ public:
     double
     rate() const
     {
-        std::lock_guard lock(m_mutex);
-        auto const tot = m_hits + m_misses;
+        auto const hits = m_hits.load();
+        auto const tot = hits + m_misses;
         if (tot == 0)
             return 0;
-        return double(m_hits) / tot;
+        return double(hits) / tot;
     }
 
     /** Fetch an item from the cache.
@@ -490,20 +513,18 @@ public:
     std::shared_ptr<T>
     fetch(key_type const& digest, Handler const& h)
     {
-        {
-            std::lock_guard l(m_mutex);
-            if (auto ret = initialFetch(digest, l))
-                return ret;
-        }
+        if (auto ret = initialFetch(digest))
+            return ret;
 
         auto sle = h();
         if (!sle)
             return {};
 
-        std::lock_guard l(m_mutex);
+        auto const p = m_cache.partition(digest);
+        std::lock_guard l(m_locks[p].mutex);
         ++m_misses;
-        auto const [it, inserted] =
-            m_cache.emplace(digest, Entry(m_clock.now(), std::move(sle)));
+        auto const [it, inserted] = m_cache.map()[p].emplace(
+            digest, Entry(m_clock.now(), std::move(sle)));
         if (!inserted)
             it->second.touch(m_clock.now());
         return it->second.ptr;
@@ -512,10 +533,14 @@ public:
 
 private:
     std::shared_ptr<T>
-    initialFetch(key_type const& key, std::lock_guard<mutex_type> const& l)
+    initialFetch(key_type const& key)
     {
-        auto cit = m_cache.find(key);
-        if (cit == m_cache.end())
+        auto const p = m_cache.partition(key);
+        std::lock_guard lock(m_locks[p].mutex);
+        auto& partition = m_cache.map()[p];
+
+        auto cit = partition.find(key);
+        if (cit == partition.end())
             return {};
 
         Entry& entry = cit->second;
@@ -534,10 +559,30 @@ private:
             return entry.ptr;
         }
 
-        m_cache.erase(cit);
+        partition.erase(cit);
         return {};
     }
 
+    // Empty every partition. The caller holds the cache-wide mutex.
+    void
+    clearPartitions()
+    {
+        for (std::size_t p = 0; p < m_cache.partitions(); ++p)
+        {
+            std::lock_guard lock(m_locks[p].mutex);
+            auto& partition = m_cache.map()[p];
+            if constexpr (!IsKeyCache)
+            {
+                for (auto const& [key, entry] : partition)
+                {
+                    if (entry.isCached())
+                        --m_cache_count;
+                }
+            }
+            partition.clear();
+        }
+    }
+
     void
     collect_metrics()
     {
@@ -546,10 +591,10 @@ private:
         {
             beast::insight::Gauge::value_type hit_rate(0);
             {
-                std::lock_guard lock(m_mutex);
-                auto const total(m_hits + m_misses);
+                auto const hits = m_hits.load();
+                auto const total(hits + m_misses);
                 if (total != 0)
-                    hit_rate = (m_hits * 100) / total;
+                    hit_rate = (hits * 100) / total;
             }
             m_stats.hit_rate.set(hit_rate);
         }
@@ -575,8 +620,8 @@ private:
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
 
-        std::size_t hits;
-        std::size_t misses;
+        std::atomic<std::size_t> hits;
+        std::atomic<std::size_t> misses;
     };
 
     class KeyOnlyEntry
@@ -655,11 +700,13 @@ private:
         clock_type::time_point const& when_expire,
         [[maybe_unused]] clock_type::time_point const& now,
         typename KeyValueCacheType::map_type& partition,
+        mutex_type& partitionMutex,
         SweptPointersVector& stuffToSweep,
         std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        std::lock_guard<mutex_type> const&)
     {
         return std::thread([&, this]() {
+            std::lock_guard lock(partitionMutex);
             int cacheRemovals = 0;
             int mapRemovals = 0;
 
@@ -729,11 +776,13 @@ private:
         clock_type::time_point const& when_expire,
         clock_type::time_point const& now,
         typename KeyOnlyCacheType::map_type& partition,
+        mutex_type& partitionMutex,
         SweptPointersVector&,
         std::atomic<int>& allRemovals,
-        std::lock_guard<std::recursive_mutex> const&)
+        std::lock_guard<mutex_type> const&)
     {
         return std::thread([&, this]() {
+            std::lock_guard lock(partitionMutex);
             int cacheRemovals = 0;
             int mapRemovals = 0;
 
@@ -771,10 +820,17 @@ private:
         });
     };
 
+    // Keeps each partition's lock on its own cache line
+    struct alignas(64) PartitionLock
+    {
+        mutex_type mutable mutex;
+    };
+
     beast::Journal m_journal;
     clock_type& m_clock;
     Stats m_stats;
 
+    // Guards the settings and the cache-wide operations
     mutex_type mutable m_mutex;
 
     // Used for logging
@@ -787,10 +843,11 @@ private:
     clock_type::duration m_target_age;
 
     // Number of items cached
-    int m_cache_count;
+    std::atomic<int> m_cache_count;
     cache_type m_cache;  // Hold strong reference to recent objects
-    std::uint64_t m_hits;
-    std::uint64_t m_misses;
+    std::vector<PartitionLock> m_locks;
+    std::atomic<std::uint64_t> m_hits;
+    std::atomic<std::uint64_t> m_misses;
 };
 
 }  // namespace ripple
@@ -215,6 +215,12 @@ STBase::downcast() const
     return *ptr;
 }
 
+inline SField const&
+STBase::getFName() const
+{
+    return *fName;
+}
+
 template <class T>
 STBase*
 STBase::emplace(std::size_t n, void* buf, T&& val)
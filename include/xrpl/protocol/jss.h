@@ -214,6 +214,7 @@ JSS(auth_change_queued);          // out: AccountInfo
 JSS(available);                   // out: ValidatorList
 JSS(avg_bps_recv);                // out: Peers
 JSS(avg_bps_sent);                // out: Peers
+JSS(avg_msgs_per_write);          // out: Peers
 JSS(balance);                     // out: AccountLines
 JSS(balances);                    // out: GatewayBalances
 JSS(base);                        // out: LogLevel
@@ -234,6 +235,8 @@ JSS(bridge);                      // in: LedgerEntry
 JSS(bridge_account);              // in: LedgerEntry
 JSS(build_path);                  // in: TransactionSign
 JSS(build_version);               // out: NetworkOPs
+JSS(bytes_in);                    // out: Peers
+JSS(bytes_out);                   // out: Peers
 JSS(cancel_after);                // out: AccountChannels
 JSS(can_delete);                  // out: CanDelete
 JSS(changes);                     // out: BookChanges
@@ -471,6 +474,7 @@ JSS(master_key);                  // out: WalletPropose, NetworkOPs,
 JSS(master_seed);                 // out: WalletPropose
 JSS(master_seed_hex);             // out: WalletPropose
 JSS(master_signature);            // out: pubManifest
+JSS(max);                         // out: Peers
 JSS(max_ledger);                  // in/out: LedgerCleaner
 JSS(max_queue_size);              // out: TxQ
 JSS(max_spend_drops);             // out: AccountInfo
@@ -480,6 +484,8 @@ JSS(median);                      // out: get_aggregate_price
 JSS(median_fee);                  // out: TxQ
 JSS(median_level);                // out: TxQ
 JSS(message);                     // error.
+JSS(messages_in);                 // out: Peers
+JSS(messages_out);                // out: Peers
 JSS(meta);                        // out: NetworkOPs, AccountTx*, Tx
 JSS(meta_blob);                   // out: NetworkOPs, AccountTx*, Tx
 JSS(metaData);
@@ -540,6 +546,8 @@ JSS(oracles);                    // in: get_aggregate_price
 JSS(oracle_document_id);         // in: get_aggregate_price
 JSS(owner);                      // in: LedgerEntry, out: NetworkOPs
 JSS(owner_funds);                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS(p50);                        // out: Peers
+JSS(p99);                        // out: Peers
 JSS(page_index);
 JSS(params);                      // RPC
 JSS(parent_close_time);           // out: LedgerToJson
@@ -563,6 +571,7 @@ JSS(ports);                       // out: NetworkOPs
 JSS(previous);                    // out: Reservations
 JSS(previous_ledger);             // out: LedgerPropose
 JSS(price);                       // out: amm_info, AuctionSlot
+JSS(processing_us);               // out: Peers
 JSS(proof);                       // in: BookOffers
 JSS(propose_seq);                 // out: LedgerPropose
 JSS(proposers);                   // out: NetworkOPs, LedgerConsensus
@@ -609,6 +618,7 @@ JSS(ripplerpc);             // ripple RPC version
 JSS(role);                  // out: Ping.cpp
 JSS(rpc);
 JSS(rt_accounts);  // in: Subscribe, Unsubscribe
+JSS(rtt_ms);                // out: Peers
 JSS(running_duration_us);
 JSS(search_depth);              // in: RipplePathFind
 JSS(searched_all);              // out: Tx
@@ -716,6 +726,9 @@ JSS(tx_unsigned);             // out: TransactionSign
 JSS(txn_count);               // out: NetworkOPs
 JSS(txr_tx_cnt);              // out: protocol message tx's count
 JSS(txr_tx_sz);               // out: protocol message tx's size
+JSS(txr_duplicate_cnt);       // out: duplicate tx count
+JSS(txr_duplicate_sz);        // out: duplicate tx size
+JSS(txr_duplicate_pct);       // out: percentage of tx that are duplicates
 JSS(txr_have_txs_cnt);        // out: protocol message have tx count
 JSS(txr_have_txs_sz);         // out: protocol message have tx size
 JSS(txr_get_ledger_cnt);      // out: protocol message get ledger count
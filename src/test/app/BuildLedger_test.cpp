@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <xrpld/app/ledger/BuildLedger.h>
+#include <xrpld/app/ledger/LedgerMaster.h>
+#include <xrpld/app/misc/CanonicalTXSet.h>
+#include <xrpld/consensus/LedgerTiming.h>
+#include <xrpld/core/Config.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class BuildLedger_test : public beast::unit_test::suite
+{
+    // Build the next ledger from the open ledger's transactions, with the
+    // given number of workers.
+    static std::shared_ptr<Ledger>
+    build(jtx::Env& env, int workers, std::size_t& failed, std::size_t& left)
+    {
+        auto const parent = env.app().getLedgerMaster().getClosedLedger();
+
+        CanonicalTXSet txns(parent->info().hash);
+        for (auto const& tx : env.current()->txs)
+            txns.insert(tx.first);
+
+        std::set<TxID> failedTxns;
+        env.app().config().LEDGER_BUILD_WORKERS = workers;
+        auto const built = buildLedger(
+            parent,
+            parent->info().closeTime + ledgerDefaultTimeResolution,
+            true,
+            ledgerDefaultTimeResolution,
+            env.app(),
+            txns,
+            failedTxns,
+            env.journal);
+        env.app().config().LEDGER_BUILD_WORKERS = 1;
+
+        failed = failedTxns.size();
+        left = txns.size();
+        return built;
+    }
+
+    void
+    testDeterminism()
+    {
+        testcase("Parallel build matches serial build");
+
+        using namespace jtx;
+
+        Env env(*this);
+
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 30; ++i)
+            accounts.emplace_back("a" + std::to_string(i));
+
+        env.fund(XRP(1000000), gw);
+        for (auto const& a : accounts)
+            env.fund(XRP(100000), a);
+        env.close();
+
+        for (auto const& a : accounts)
+            env(trust(a, USD(1000000)));
+        env.close();
+
+        for (auto const& a : accounts)
+            env(pay(gw, a, USD(10000)));
+        env.close();
+
+        // A mix of traffic in one ledger: payments between a few busy
+        // accounts and many quiet ones, and offers that cross each other.
+        // Accounts submit several transactions each, so many of them read
+        // what an earlier one wrote.
+        for (int i = 0; i < 600; ++i)
+        {
+            auto const& from = accounts[(i * 7) % accounts.size()];
+            auto const& to =
+                accounts[i % 5 == 0 ? 0 : (i * 13 + 1) % accounts.size()];
+
+            switch (i % 4)
+            {
+                case 0:
+                    env(pay(from, to, XRP(10 + i % 17)), ter(std::ignore));
+                    break;
+                case 1:
+                    env(pay(from, to, USD(5 + i % 11)), ter(std::ignore));
+                    break;
+                case 2:
+                    env(offer(from, USD(20), XRP(20 + i % 3)),
+                        ter(std::ignore));
+                    break;
+                case 3:
+                    env(offer(from, XRP(20 + i % 3), USD(20)),
+                        ter(std::ignore));
+                    break;
+            }
+        }
+
+        std::size_t failed = 0;
+        std::size_t left = 0;
+        auto const serial = build(env, 1, failed, left);
+        BEAST_EXPECT(serial->txMap().getHash().isNonZero());
+
+        for (int workers : {2, 4, 8})
+        {
+            std::size_t pFailed = 0;
+            std::size_t pLeft = 0;
+            auto const parallel = build(env, workers, pFailed, pLeft);
+
+            BEAST_EXPECT(parallel->info().hash == serial->info().hash);
+            BEAST_EXPECT(
+                parallel->info().accountHash == serial->info().accountHash);
+            BEAST_EXPECT(parallel->info().txHash == serial->info().txHash);
+            BEAST_EXPECT(parallel->info().drops == serial->info().drops);
+            BEAST_EXPECT(pFailed == failed);
+            BEAST_EXPECT(pLeft == left);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testDeterminism();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BuildLedger, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
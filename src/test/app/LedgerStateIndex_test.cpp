@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <xrpld/app/ledger/LedgerMaster.h>
+#include <xrpld/app/ledger/LedgerStateIndex.h>
+#include <xrpld/nodestore/Manager.h>
+
+namespace ripple {
+namespace test {
+
+class LedgerStateIndex_test : public beast::unit_test::suite
+{
+    static std::unique_ptr<LedgerStateIndex>
+    makeIndex(jtx::Env& env)
+    {
+        Section section;
+        section.set("type", "memory");
+        section.set("path", "state_index_test");
+        auto const j = env.app().journal("StateIndex");
+        return std::make_unique<LedgerStateIndex>(
+            env.app(),
+            NodeStore::Manager::instance().make_StateIndex(section, j),
+            j);
+    }
+
+    static std::shared_ptr<Ledger const>
+    closed(jtx::Env& env)
+    {
+        return env.app().getLedgerMaster().getLedgerBySeq(env.closed()->seq());
+    }
+
+    // Check that a view reads the same state as its ledger
+    void
+    expectSame(ReadView const& view, ReadView const& ledger)
+    {
+        std::vector<std::pair<uint256, Blob>> expected;
+        for (auto const& sle : ledger.sles)
+            expected.emplace_back(sle->key(), sle->getSerializer().getData());
+
+        std::vector<std::pair<uint256, Blob>> actual;
+        for (auto const& sle : view.sles)
+            actual.emplace_back(sle->key(), sle->getSerializer().getData());
+        BEAST_EXPECT(actual == expected);
+
+        for (auto const& [key, data] : expected)
+        {
+            auto const sle = view.read(keylet::unchecked(key));
+            BEAST_EXPECT(sle && sle->getSerializer().getData() == data);
+            BEAST_EXPECT(view.succ(key) == ledger.succ(key));
+            auto const next = view.sles.upper_bound(key);
+            auto const expectedNext = ledger.sles.upper_bound(key);
+            if (expectedNext == ledger.sles.end())
+                BEAST_EXPECT(next == view.sles.end());
+            else
+                BEAST_EXPECT(
+                    next != view.sles.end() &&
+                    (*next)->key() == (*expectedNext)->key());
+        }
+    }
+
+    void
+    testIndex()
+    {
+        testcase("Index");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        Account const alice("alice");
+        Account const bob("bob");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice, bob);
+        env.trust(USD(1000), alice, bob);
+        env.close();
+
+        auto index = makeIndex(env);
+
+        // Nothing is served before a ledger is indexed
+        auto const first = closed(env);
+        BEAST_EXPECT(index->view(first) == first);
+
+        index->update(first);
+        auto const firstView = index->view(first);
+        BEAST_EXPECT(firstView != first);
+        BEAST_EXPECT(firstView->info().hash == first->info().hash);
+        expectSame(*firstView, *first);
+
+        // Changes and deletions are applied from the next ledger
+        env(pay(gw, alice, USD(50)));
+        env(trust(bob, USD(0)));
+        env.close();
+        auto const second = closed(env);
+        index->update(second);
+        expectSame(*index->view(second), *second);
+        BEAST_EXPECT(
+            index->view(second)->exists(keylet::line(bob, USD.issue())) ==
+            second->exists(keylet::line(bob, USD.issue())));
+
+        // Earlier ledgers keep their own state
+        expectSame(*index->view(first), *first);
+        BEAST_EXPECT(
+            index->view(first)->exists(keylet::line(bob, USD.issue())));
+
+        // Skipped ledgers are brought in from the ledger history
+        env(pay(alice, bob, XRP(10)));
+        env.close();
+        env(pay(bob, alice, XRP(5)));
+        env.close();
+        auto const fourth = closed(env);
+        index->update(fourth);
+        expectSame(*index->view(fourth), *fourth);
+        auto const third = env.app().getLedgerMaster().getLedgerBySeq(
+            fourth->info().seq - 1);
+        expectSame(*index->view(third), *third);
+        expectSame(*index->view(first), *first);
+
+        // Open ledgers are never served from the index
+        BEAST_EXPECT(index->view(env.current()) == env.current());
+    }
+
+    void
+    testRebuild()
+    {
+        testcase("Rebuild");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const alice("alice");
+
+        env.fund(XRP(10000), alice);
+        env.close();
+
+        auto index = makeIndex(env);
+        auto const first = closed(env);
+        index->update(first);
+        auto const firstView = index->view(first);
+        BEAST_EXPECT(firstView != first);
+
+        // A long gap starts a new range instead of being filled in
+        env(noop(alice));
+        for (int i = 0; i < 300; ++i)
+            env.close();
+        auto const last = closed(env);
+        index->update(last);
+        expectSame(*index->view(last), *last);
+        BEAST_EXPECT(index->view(first) == first);
+
+        // Views made before the rebuild read their ledger instead
+        expectSame(*firstView, *first);
+    }
+
+    void
+    testPrune()
+    {
+        testcase("Prune");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        Account const alice("alice");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+
+        auto index = makeIndex(env);
+        auto const first = closed(env);
+        index->update(first);
+
+        // Change and delete entries across several ledgers
+        env.trust(USD(1000), alice);
+        env.close();
+        index->update(closed(env));
+        env(pay(gw, alice, USD(50)));
+        env.close();
+        auto const third = closed(env);
+        index->update(third);
+        env(pay(alice, gw, USD(50)));
+        env(trust(alice, USD(0)));
+        env.close();
+        auto const fourth = closed(env);
+        index->update(fourth);
+        auto const thirdView = index->view(third);
+
+        // Pruning at the start of the range does nothing
+        index->prune(first->info().seq);
+        BEAST_EXPECT(index->range()->first == first->info().seq);
+
+        index->prune(third->info().seq);
+        auto const range = index->range();
+        BEAST_EXPECT(
+            range && range->first == third->info().seq &&
+            range->second == fourth->info().seq);
+
+        // Pruned ledgers are no longer served from the index
+        BEAST_EXPECT(index->view(first) == first);
+
+        // The ledgers that are kept still read their own state
+        BEAST_EXPECT(index->view(third) != third);
+        expectSame(*index->view(third), *third);
+        expectSame(*index->view(fourth), *fourth);
+        BEAST_EXPECT(
+            index->view(third)->exists(keylet::line(alice, USD.issue())));
+        BEAST_EXPECT(
+            !index->view(fourth)->exists(keylet::line(alice, USD.issue())));
+
+        // Views made before pruning read their ledger instead
+        expectSame(*thirdView, *third);
+
+        // New ledgers are still added after the pruned range
+        env(pay(gw, alice, XRP(10)));
+        env.close();
+        auto const fifth = closed(env);
+        index->update(fifth);
+        BEAST_EXPECT(index->range()->second == fifth->info().seq);
+        expectSame(*index->view(fifth), *fifth);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIndex();
+        testRebuild();
+        testPrune();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerStateIndex, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <test/jtx/AMM.h>
+#include <xrpld/app/ledger/AcceptedLedger.h>
+#include <xrpld/app/ledger/OrderBookDB.h>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Apply the last closed ledger to the index
+    static void
+    apply(jtx::Env& env, OrderBookDB& db)
+    {
+        db.update(AcceptedLedger(env.closed(), env.app()));
+    }
+
+    static void
+    advance(jtx::Env& env, OrderBookDB& db)
+    {
+        env.close();
+        apply(env, db);
+    }
+
+    void
+    testIncremental()
+    {
+        testcase("Incremental update");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        Account const bob("bob");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, bob);
+        env.trust(USD(1000), bob);
+        env.close();
+
+        // Offer sequence numbers, for cancelling them later
+        auto const gwSeq = env.seq(gw);
+        env(offer(gw, XRP(10), USD(10)));
+        env.close();
+
+        OrderBookDB db(env.app());
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // A new book is picked up from the next ledger
+        auto const bobSeq = env.seq(bob);
+        env(offer(bob, USD(10), XRP(5)));
+        advance(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        // Another offer in an existing book changes nothing
+        env(offer(gw, XRP(20), USD(10)));
+        advance(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // Books disappear with their last offer
+        env(offer_cancel(bob, bobSeq));
+        advance(env, db);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        env(offer_cancel(gw, gwSeq));
+        advance(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        env(offer_cancel(gw, gwSeq + 1));
+        advance(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+
+        // Ledgers that are already covered are ignored
+        apply(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+    }
+
+    void
+    testGap()
+    {
+        testcase("Gap");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw);
+        env.close();
+
+        OrderBookDB db(env.app());
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+
+        // A skipped ledger forces a full update
+        env(offer(gw, XRP(10), USD(10)));
+        env.close();
+        env.close();
+        apply(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // and incremental updates resume from there
+        env(offer(gw, USD(10), XRP(5)));
+        advance(env, db);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+    }
+
+    void
+    testRepeatedSetup()
+    {
+        testcase("Repeated setup");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw);
+        env(offer(gw, XRP(10), USD(10)));
+        env.close();
+
+        // Setting up twice from the same ledger leaves the index usable
+        OrderBookDB db(env.app());
+        db.setup(env.closed());
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // and the changes of the following ledgers are all applied
+        env(offer(gw, USD(10), XRP(5)));
+        advance(env, db);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        env(offer_cancel(gw, env.seq(gw) - 1));
+        advance(env, db);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+    }
+
+    void
+    testAMM()
+    {
+        testcase("AMM");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(30000), gw);
+        env.close();
+
+        OrderBookDB db(env.app());
+        db.setup(env.closed());
+
+        // Creating and deleting the AMM closes the ledger
+        AMM amm(env, gw, XRP(10000), USD(10000));
+        apply(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        amm.withdrawAll(gw);
+        BEAST_EXPECT(!amm.ammExists());
+        apply(env, db);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testGap();
+        testRepeatedSetup();
+        testAMM();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -19,13 +19,16 @@
 
 #include <test/jtx.h>
 #include <test/jtx/envconfig.h>
+#include <xrpld/app/misc/NetworkOPs.h>
 #include <xrpld/app/paths/AccountCurrencies.h>
+#include <xrpld/app/paths/PathRequests.h>
 #include <xrpld/core/JobQueue.h>
 #include <xrpld/rpc/Context.h>
 #include <xrpld/rpc/RPCHandler.h>
 #include <xrpld/rpc/detail/RPCHelpers.h>
 #include <xrpld/rpc/detail/Tuning.h>
 #include <xrpl/basics/contract.h>
+#include <xrpl/beast/insight/NullCollector.h>
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/json/json_reader.h>
 #include <xrpl/json/to_string.h>
@@ -33,6 +36,7 @@
 #include <xrpl/protocol/TxFlags.h>
 #include <xrpl/protocol/jss.h>
 #include <xrpl/resource/Fees.h>
+#include <xrpl/resource/ResourceManager.h>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
@@ -1345,6 +1349,189 @@ public:
         test("no ripple -> no ripple", false, false, false);
     }
 
+    // Collects the path_find updates sent to a subscriber
+    class PathSubscriber : public InfoSub
+    {
+        std::mutex mutex_;
+        std::vector<Json::Value> updates_;
+
+    public:
+        PathSubscriber(Source& source, Resource::Consumer consumer)
+            : InfoSub(source, consumer)
+        {
+        }
+
+        using InfoSub::send;
+
+        void
+        send(Json::Value const& jv, bool) override
+        {
+            std::lock_guard lock(mutex_);
+            updates_.push_back(jv);
+        }
+
+        std::vector<Json::Value>
+        updates()
+        {
+            std::lock_guard lock(mutex_);
+            return updates_;
+        }
+    };
+
+    // Updates a set of path_find subscriptions once with the given number
+    // of workers, and returns the update each subscriber received
+    std::vector<Json::Value>
+    update_path_requests(int workers)
+    {
+        using namespace jtx;
+        Env env(*this, envconfig([workers](std::unique_ptr<Config> cfg) {
+            cfg->FORCE_MULTI_THREAD = true;
+            cfg->WORKERS = 4;
+            cfg->PATH_SEARCH_WORKERS = workers;
+            return cfg;
+        }));
+
+        auto const gw1 = Account("gateway1");
+        auto const gw2 = Account("gateway2");
+        auto const USD1 = gw1["USD"];
+        auto const USD2 = gw2["USD"];
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        Account const dan("dan");
+
+        env.fund(XRP(10000), alice, bob, carol, dan, gw1, gw2);
+        env.trust(USD1(1000), alice, bob, carol, dan);
+        env.trust(USD2(1000), alice, bob, carol, dan);
+        env(pay(gw1, alice, USD1(100)));
+        env(pay(gw2, bob, USD2(100)));
+        env(pay(gw1, carol, USD1(100)));
+        env(pay(gw2, dan, USD2(100)));
+        env(offer(carol, XRP(100), USD1(50)));
+        env(offer(dan, USD1(50), USD2(50)));
+        env.close();
+
+        // Use a separate set of requests, so that only updateAll below
+        // updates them
+        PathRequests requests(
+            env.app(), env.journal, beast::insight::NullCollector::New());
+
+        std::vector<std::tuple<Account, Account, STAmount>> const searches{
+            {alice, bob, bob["USD"](10)},
+            {bob, alice, alice["USD"](10)},
+            {alice, dan, dan["USD"](10)},
+            {carol, bob, bob["USD"](5)},
+            {dan, alice, alice["USD"](5)},
+            {alice, carol, XRP(10)},
+            {bob, carol, carol["USD"](20)},
+            {dan, bob, XRP(5)},
+        };
+
+        auto const ledger = env.closed();
+        std::vector<std::shared_ptr<PathSubscriber>> subscribers;
+        for (auto const& [src, dst, amount] : searches)
+        {
+            auto sub = std::make_shared<PathSubscriber>(
+                env.app().getOPs(),
+                env.app().getResourceManager().newInboundEndpoint(
+                    beast::IP::Endpoint::from_string("127.0.0.1")));
+
+            Json::Value params = Json::objectValue;
+            params[jss::source_account] = src.human();
+            params[jss::destination_account] = dst.human();
+            params[jss::destination_amount] =
+                amount.getJson(JsonOptions::none);
+            auto const result = requests.makePathRequest(sub, ledger, params);
+            BEAST_EXPECT(!result.isMember(jss::error));
+            subscribers.push_back(std::move(sub));
+        }
+
+        requests.updateAll(ledger);
+
+        std::vector<Json::Value> updates;
+        for (auto const& sub : subscribers)
+        {
+            auto const received = sub->updates();
+            if (!BEAST_EXPECT(received.size() == 1))
+                return {};
+            BEAST_EXPECT(received[0][jss::type] == "path_find");
+            BEAST_EXPECT(!received[0].isMember(jss::error));
+            updates.push_back(received[0][jss::alternatives]);
+        }
+        return updates;
+    }
+
+    void
+    parallel_path_request_updates()
+    {
+        testcase("parallel path request updates");
+
+        auto const serial = update_path_requests(1);
+        BEAST_EXPECT(serial.size() == 8);
+
+        // Some searches must find paths for the comparison to mean much
+        BEAST_EXPECT(std::any_of(
+            serial.begin(), serial.end(), [](Json::Value const& alts) {
+                return alts.size() > 0;
+            }));
+
+        for (int workers : {2, 4, 8})
+            BEAST_EXPECT(update_path_requests(workers) == serial);
+    }
+
+    void
+    path_request_deadline()
+    {
+        testcase("path request deadline");
+        using namespace jtx;
+        Env env(*this);
+
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(1000), "alice", "bob");
+        env(pay(gw, "alice", USD(100)));
+        env.close();
+
+        PathRequests requests(
+            env.app(), env.journal, beast::insight::NullCollector::New());
+
+        auto const sub = std::make_shared<PathSubscriber>(
+            env.app().getOPs(),
+            env.app().getResourceManager().newInboundEndpoint(
+                beast::IP::Endpoint::from_string("127.0.0.1")));
+
+        Json::Value params = Json::objectValue;
+        params[jss::source_account] = Account("alice").human();
+        params[jss::destination_account] = Account("bob").human();
+        params[jss::destination_amount] =
+            Account("bob")["USD"](10).getJson(JsonOptions::none);
+
+        auto const ledger = env.closed();
+        auto const result = requests.makePathRequest(sub, ledger, params);
+        BEAST_EXPECT(!result.isMember(jss::error));
+
+        requests.updateAll(ledger);
+        auto const received = sub->updates();
+        if (!BEAST_EXPECT(received.size() == 1))
+            return;
+        auto const& alternatives = received[0][jss::alternatives];
+        BEAST_EXPECT(alternatives.size() > 0);
+
+        auto const request =
+            std::dynamic_pointer_cast<PathRequest>(sub->getRequest());
+        if (!BEAST_EXPECT(request))
+            return;
+
+        // A search whose deadline has already passed keeps the previous
+        // alternatives instead of reporting none
+        auto const cache = requests.getLineCache(ledger, false);
+        auto const update =
+            request->doUpdate(cache, false, [] { return false; });
+        BEAST_EXPECT(!update.isMember(jss::error));
+        BEAST_EXPECT(update[jss::alternatives] == alternatives);
+    }
+
     void
     run() override
     {
@@ -1369,6 +1556,8 @@ public:
         xrp_to_xrp();
         receive_max();
         noripple_combinations();
+        parallel_path_request_updates();
+        path_request_deadline();
 
         // The following path_find_NN tests are data driven tests
         // that were originally implemented in js/coffee and migrated
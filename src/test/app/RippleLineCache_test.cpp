@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <xrpld/app/ledger/AcceptedLedger.h>
+#include <xrpld/app/paths/RippleLineCache.h>
+
+namespace ripple {
+namespace test {
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    void
+    testDerived()
+    {
+        testcase("Derived cache");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gateway");
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.trust(USD(1000), alice, bob);
+        env.close();
+
+        auto const j = env.app().journal("RippleLineCache");
+        auto const outgoing = LineDirection::outgoing;
+
+        RippleLineCache parent(env.closed(), j);
+        auto const aliceLines = parent.getRippleLines(alice, outgoing);
+        auto const bobLines = parent.getRippleLines(bob, outgoing);
+        auto const carolLines = parent.getRippleLines(carol, outgoing);
+        BEAST_EXPECT(aliceLines && aliceLines->size() == 1);
+        BEAST_EXPECT(bobLines && bobLines->size() == 1);
+        BEAST_EXPECT(!carolLines);
+
+        // Change alice's line and give carol one
+        env(pay(gw, alice, USD(50)));
+        env.trust(USD(1000), carol);
+        env.close();
+
+        RippleLineCache child(
+            parent, AcceptedLedger(env.closed(), env.app()), j);
+        BEAST_EXPECT(child.getLedger() == env.closed());
+
+        // Untouched accounts are carried over
+        BEAST_EXPECT(child.getRippleLines(bob, outgoing) == bobLines);
+
+        // Touched accounts are read again
+        auto const aliceNow = child.getRippleLines(alice, outgoing);
+        BEAST_EXPECT(aliceNow && aliceNow != aliceLines);
+        BEAST_EXPECT(
+            aliceNow && aliceNow->size() == 1 &&
+            aliceNow->front().getBalance() == USD(50));
+
+        auto const carolNow = child.getRippleLines(carol, outgoing);
+        BEAST_EXPECT(carolNow && carolNow->size() == 1);
+
+        // The parent still sees its own ledger
+        BEAST_EXPECT(parent.getRippleLines(alice, outgoing) == aliceLines);
+        BEAST_EXPECT(!parent.getRippleLines(carol, outgoing));
+    }
+
+public:
+    void
+    run() override
+    {
+        testDerived();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -17,8 +17,12 @@
 */
 //==============================================================================
 
-#include <test/jtx/Env.h>
+#include <test/jtx.h>
+#include <xrpld/app/ledger/OpenLedger.h>
+#include <xrpld/app/misc/HashRouter.h>
+#include <xrpld/app/misc/TxQ.h>
 #include <xrpld/app/tx/apply.h>
+#include <xrpld/app/tx/applySteps.h>
 #include <xrpl/basics/StringUtilities.h>
 #include <xrpl/protocol/Feature.h>
 
@@ -32,6 +36,10 @@ public:
     {
         testcase("Require Fully Canonicial Signature");
         testFullyCanonicalSigs();
+        testcase("Check Signatures");
+        testCheckSignatures();
+        testcase("Apply Preflighted");
+        testApplyPreflighted();
     }
 
     void
@@ -83,6 +91,98 @@ public:
 
         pass();
     }
+
+    void
+    testCheckSignatures()
+    {
+        using namespace test::jtx;
+
+        // A payment signed without a fully-canonical signature
+        auto ret = strUnHex(
+            "12000022000000002400000001201B00497D9C6140000000000F6950684000000"
+            "00000000C732103767C7B2C13AD90050A4263745E4BAB2B975417FA22E87780E1"
+            "506DDAF21139BE74483046022100E95670988A34C4DB0FA73A8BFD6383872AF43"
+            "8C147A62BC8387406298C3EADC1022100A7DC80508ED5A4750705C702A81CBF9D"
+            "2C2DC3AFEDBED37BBCCD97BC8C40E08F8114E25A26437D923EEF4D6D815DF9336"
+            "8B62E6440848314BB85996936E4F595287774684DC2AC6266024BEF");
+        SerialIter sit(makeSlice(*ret));
+        auto const bad = std::make_shared<STTx const>(std::ref(sit));
+
+        Env env(*this);
+        Account const alice("alice", KeyType::ed25519);
+        Account const bob("bob");
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto const fromAlice = env.jt(pay(alice, bob, XRP(10))).stx;
+        auto const fromBob = env.jt(pay(bob, alice, XRP(10))).stx;
+
+        std::vector<std::shared_ptr<STTx const>> const batch{
+            fromAlice, bad, fromBob};
+        auto& router = env.app().getHashRouter();
+        auto const& rules = env.current()->rules();
+        checkSignatures(router, batch, rules);
+
+        // The results are cached for checkValidity
+        BEAST_EXPECT(router.getFlags(fromAlice->getTransactionID()) != 0);
+        BEAST_EXPECT(router.getFlags(bad->getTransactionID()) != 0);
+        BEAST_EXPECT(router.getFlags(fromBob->getTransactionID()) != 0);
+
+        auto const& config = env.app().config();
+        BEAST_EXPECT(
+            checkValidity(router, *fromAlice, rules, config).first ==
+            Validity::Valid);
+        BEAST_EXPECT(
+            checkValidity(router, *bad, rules, config).first ==
+            Validity::SigBad);
+        BEAST_EXPECT(
+            checkValidity(router, *fromBob, rules, config).first ==
+            Validity::Valid);
+    }
+
+    void
+    testApplyPreflighted()
+    {
+        using namespace test::jtx;
+
+        Env env(*this);
+        Account const alice("alice");
+        Account const bob("bob");
+        env.fund(XRP(10000), alice, bob);
+        env.close();
+
+        auto const good = env.jt(pay(alice, bob, XRP(10))).stx;
+        auto const redundant = env.jt(pay(alice, alice, XRP(10))).stx;
+
+        // Preflight without the ledger, as a batch is checked before the
+        // open ledger is locked. The signature check is cached.
+        auto const& rules = env.current()->rules();
+        auto const pfGood =
+            preflight(env.app(), rules, *good, tapNONE, env.journal);
+        auto const pfRedundant =
+            preflight(env.app(), rules, *redundant, tapNONE, env.journal);
+        BEAST_EXPECT(pfGood.ter == tesSUCCESS);
+        BEAST_EXPECT(pfRedundant.ter == temREDUNDANT);
+        BEAST_EXPECT(
+            env.app().getHashRouter().getFlags(good->getTransactionID()) != 0);
+
+        env.app().openLedger().modify([&](OpenView& view, beast::Journal j) {
+            auto& txq = env.app().getTxQ();
+
+            auto const rejected =
+                txq.apply(env.app(), view, redundant, pfRedundant, j);
+            BEAST_EXPECT(rejected.first == temREDUNDANT);
+            BEAST_EXPECT(!rejected.second);
+
+            auto const applied = txq.apply(env.app(), view, good, pfGood, j);
+            BEAST_EXPECT(applied.first == tesSUCCESS);
+            BEAST_EXPECT(applied.second);
+            return applied.second;
+        });
+
+        env.close();
+        BEAST_EXPECT(env.balance(bob) == XRP(10010));
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(Apply, app, ripple);
@@ -24,6 +24,13 @@
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/protocol/Protocol.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
 namespace ripple {
 
 /*
@@ -148,9 +155,122 @@ public:
             BEAST_EXPECT(c.getCacheSize() == 0);
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
+
+        // Threads racing to canonicalize the same keys all end up with
+        // the same objects.
+        {
+            int const keys = 1000;
+            std::vector<std::vector<std::shared_ptr<Value>>> seen(8);
+            std::vector<std::thread> threads;
+            for (auto& s : seen)
+            {
+                threads.emplace_back([&c, &s, keys] {
+                    for (int k = 0; k < keys; ++k)
+                    {
+                        auto p = std::make_shared<Value>(std::to_string(k));
+                        c.canonicalize_replace_client(100 + k, p);
+                        s.push_back(p);
+                    }
+                });
+            }
+            for (auto& t : threads)
+                t.join();
+
+            BEAST_EXPECT(c.getCacheSize() == keys);
+            BEAST_EXPECT(c.getTrackSize() == keys);
+            bool same = true;
+            for (int k = 0; k < keys; ++k)
+            {
+                auto const p = c.fetch(100 + k);
+                for (auto const& s : seen)
+                    same = same && s[k] == p;
+            }
+            BEAST_EXPECT(same);
+
+            c.clear();
+            BEAST_EXPECT(c.getCacheSize() == 0);
+            BEAST_EXPECT(c.getTrackSize() == 0);
+        }
+    }
+};
+
+// Measures cache throughput with many threads fetching and canonicalizing
+// random keys, as the node store and tree node caches see when fetching
+// in parallel.
+class TaggedCacheBench_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace std::chrono_literals;
+        testcase("Contention");
+
+        test::SuiteJournal journal("TaggedCacheBench_test", *this);
+        TestStopwatch clock;
+        clock.set(0);
+
+        using Cache = TaggedCache<uint256, std::string>;
+        Cache c("bench", 100000, 1min, clock, journal);
+
+        int const keys = 100000;
+        int const ops = 200000;
+        std::vector<uint256> ids;
+        ids.reserve(keys);
+        std::mt19937_64 rng(42);
+        for (int i = 0; i < keys; ++i)
+        {
+            uint256 id;
+            for (auto& b : id)
+                b = static_cast<std::uint8_t>(rng());
+            ids.push_back(id);
+        }
+
+        for (int threads : {1, 4, 16, 32})
+        {
+            c.reset();
+            std::atomic<std::uint64_t> found{0};
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&, t] {
+                    std::mt19937 r(t);
+                    std::uniform_int_distribution<int> pick(0, keys - 1);
+                    std::uint64_t n = 0;
+                    for (int i = 0; i < ops; ++i)
+                    {
+                        auto const& id = ids[pick(r)];
+                        if (c.fetch(id))
+                        {
+                            ++n;
+                            continue;
+                        }
+                        auto p = std::make_shared<std::string>("value");
+                        c.canonicalize_replace_client(id, p);
+                    }
+                    found += n;
+                });
+            }
+            for (auto& w : workers)
+                w.join();
+
+            auto const elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+            auto const total = std::uint64_t(threads) * ops;
+            std::cout << threads << " threads: " << total << " operations in "
+                      << elapsed.count() << "ms, "
+                      << total * 1000 / std::max<std::int64_t>(
+                                            elapsed.count(), 1)
+                      << " per second\n";
+            BEAST_EXPECT(found != 0);
+            BEAST_EXPECT(c.getTrackSize() <= keys);
+        }
     }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache, common, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCacheBench, common, ripple);
 
 }  // namespace ripple
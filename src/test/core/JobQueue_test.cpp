@@ -19,8 +19,16 @@
 
 #include <test/jtx/Env.h>
 #include <xrpld/core/JobQueue.h>
+#include <xrpld/perflog/PerfLog.h>
+#include <xrpl/beast/insight/NullCollector.h>
 #include <xrpl/beast/unit_test.h>
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
 namespace ripple {
 namespace test {
 
@@ -149,16 +157,223 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testPriority()
+    {
+        testcase("priority and limits");
+
+        jtx::Env env{*this};
+
+        {
+            // With one thread, queued jobs run highest priority first and
+            // in the order they were added within a priority.
+            JobQueue jq(
+                1,
+                beast::insight::NullCollector::New(),
+                env.journal,
+                env.app().logs(),
+                env.app().getPerfLog());
+
+            std::atomic<bool> release{false};
+            jq.addJob(jtCLIENT, "JobBlock", [&release]() {
+                while (!release)
+                    std::this_thread::yield();
+            });
+            while (jq.getJobCount(jtCLIENT) != 0)
+                std::this_thread::yield();
+
+            std::vector<int> order;
+            int id = 0;
+            for (auto const type :
+                 {jtCLIENT,
+                  jtTRANSACTION,
+                  jtCLIENT,
+                  jtADMIN,
+                  jtTRANSACTION,
+                  jtPACK})
+            {
+                jq.addJob(type, "JobOrder", [&order, n = id++]() {
+                    order.push_back(n);
+                });
+            }
+            BEAST_EXPECT(jq.getJobCount(jtTRANSACTION) == 2);
+            BEAST_EXPECT(jq.getJobCountGE(jtTRANSACTION) == 3);
+
+            release = true;
+            jq.rendezvous();
+            BEAST_EXPECT((order == std::vector<int>{3, 1, 4, 0, 2, 5}));
+            jq.stop();
+        }
+        {
+            // The limit of a job type holds with many idle threads.
+            JobQueue jq(
+                8,
+                beast::insight::NullCollector::New(),
+                env.journal,
+                env.app().logs(),
+                env.app().getPerfLog());
+
+            std::atomic<int> running{0};
+            std::atomic<int> peak{0};
+            std::atomic<int> done{0};
+            for (int i = 0; i < 100; ++i)
+            {
+                jq.addJob(jtUPDATE_PF, "JobLimit", [&]() {
+                    auto const n = ++running;
+                    for (auto p = peak.load(); n > p;)
+                        peak.compare_exchange_weak(p, n);
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    --running;
+                    ++done;
+                });
+            }
+            jq.rendezvous();
+            BEAST_EXPECT(done == 100);
+            BEAST_EXPECT(peak == 1);
+            jq.stop();
+        }
+    }
+
+    void
+    testParallelFor()
+    {
+        testcase("parallelFor");
+
+        jtx::Env env{*this};
+        JobQueue jq(
+            4,
+            beast::insight::NullCollector::New(),
+            env.journal,
+            env.app().logs(),
+            env.app().getPerfLog());
+
+        {
+            // Every index is visited exactly once
+            std::vector<std::atomic<int>> visits(10000);
+            jq.parallelFor(
+                jtCLIENT, "ParallelFor", visits.size(), 4, [&](std::size_t i) {
+                    ++visits[i];
+                });
+            BEAST_EXPECT(std::all_of(
+                visits.begin(), visits.end(), [](auto const& v) {
+                    return v == 1;
+                }));
+
+            int calls = 0;
+            jq.parallelFor(jtCLIENT, "ParallelFor", 0, 4, [&](std::size_t) {
+                ++calls;
+            });
+            BEAST_EXPECT(calls == 0);
+        }
+        {
+            // The calling thread does all the work when no job can run
+            std::atomic<bool> release{false};
+            for (int i = 0; i < 4; ++i)
+                jq.addJob(jtCLIENT, "JobBlock", [&release]() {
+                    while (!release)
+                        std::this_thread::yield();
+                });
+
+            std::atomic<int> calls{0};
+            jq.parallelFor(jtCLIENT, "ParallelFor", 100, 4, [&](std::size_t) {
+                ++calls;
+            });
+            BEAST_EXPECT(calls == 100);
+            release = true;
+            jq.rendezvous();
+        }
+        {
+            // An exception is rethrown after all the other calls are made
+            std::atomic<int> calls{0};
+            try
+            {
+                jq.parallelFor(
+                    jtCLIENT, "ParallelFor", 1000, 4, [&](std::size_t i) {
+                        ++calls;
+                        if (i == 500)
+                            Throw<std::runtime_error>("parallelFor");
+                    });
+                fail();
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+            BEAST_EXPECT(calls == 1000);
+        }
+
+        jq.rendezvous();
+        jq.stop();
+    }
+
 public:
     void
     run() override
     {
         testAddJob();
         testPostCoro();
+        testPriority();
+        testParallelFor();
+    }
+};
+
+// Measures the rate at which small jobs of the types peers produce most
+// are added and dispatched.
+class JobQueueBench_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase("jobs per second");
+
+        using clock = std::chrono::steady_clock;
+        jtx::Env env{*this};
+
+        int const producers = 4;
+        int const jobsPerProducer = 250'000;
+        for (int const threads : {16, 32, 64})
+        {
+            JobQueue jq(
+                threads,
+                beast::insight::NullCollector::New(),
+                env.journal,
+                env.app().logs(),
+                env.app().getPerfLog());
+
+            std::atomic<std::uint64_t> ran{0};
+            auto const start = clock::now();
+            std::vector<std::thread> adders;
+            for (int p = 0; p < producers; ++p)
+            {
+                adders.emplace_back([&, p]() {
+                    JobType const types[] = {
+                        jtTRANSACTION,
+                        jtVALIDATION_ut,
+                        jtPROPOSAL_ut,
+                        jtCLIENT};
+                    for (int i = 0; i < jobsPerProducer; ++i)
+                        jq.addJob(types[(i + p) % 4], "JobBench", [&ran]() {
+                            ++ran;
+                        });
+                });
+            }
+            for (auto& t : adders)
+                t.join();
+            jq.rendezvous();
+
+            std::chrono::duration<double> const elapsed = clock::now() - start;
+            std::cout << threads << " threads: "
+                      << static_cast<std::uint64_t>(ran / elapsed.count())
+                      << " jobs/sec\n";
+            BEAST_EXPECT(ran == producers * jobsPerProducer);
+            jq.stop();
+        }
     }
 };
 
 BEAST_DEFINE_TESTSUITE(JobQueue, core, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueueBench, core, ripple);
 
 }  // namespace test
 }  // namespace ripple
@@ -546,6 +546,19 @@ public:
                 fetchCopyOfBatch(*db, &copy, batch);
                 BEAST_EXPECT(areBatchesEqual(batch, copy));
             }
+
+            {
+                // Read it back in one batch, with a key that isn't there
+                std::vector<uint256> hashes;
+                for (auto const& object : batch)
+                    hashes.push_back(object->getHash());
+                hashes.push_back(uint256{});
+                auto const objects = db->fetchBatch(hashes);
+                BEAST_EXPECT(objects.size() == hashes.size());
+                BEAST_EXPECT(objects.back() == nullptr);
+                Batch copy(objects.begin(), objects.end() - 1);
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
         }
 
         if (testPersistence)
@@ -145,7 +145,10 @@ class Timing_test : public beast::unit_test::suite
 public:
     enum {
         // percent of fetches for missing nodes
-        missingNodePercent = 20
+        missingNodePercent = 20,
+
+        // number of keys requested by each batched fetch
+        fetchBatchSize = 256
     };
 
     std::size_t const default_repeat = 3;
@@ -392,6 +395,166 @@ public:
         backend->close();
     }
 
+    // Fetch existing keys in groups, one key at a time.
+    // The backend is freshly opened so the reads start with cold caches.
+    void
+    do_fetch_serial(
+        Section const& config,
+        Params const& params,
+        beast::Journal journal)
+    {
+        DummyScheduler scheduler;
+        auto backend = make_Backend(config, scheduler, journal);
+        BEAST_EXPECT(backend != nullptr);
+        backend->open();
+
+        class Body
+        {
+        private:
+            suite& suite_;
+            Backend& backend_;
+            Sequence seq1_;
+            beast::xor_shift_engine gen_;
+            std::uniform_int_distribution<std::size_t> dist_;
+
+        public:
+            Body(
+                std::size_t id,
+                suite& s,
+                Params const& params,
+                Backend& backend)
+                : suite_(s)
+                , backend_(backend)
+                , seq1_(1)
+                , gen_(id + 1)
+                , dist_(0, params.items - 1)
+            {
+            }
+
+            void
+            operator()(std::size_t i)
+            {
+                try
+                {
+                    for (std::size_t j = 0; j < fetchBatchSize; ++j)
+                    {
+                        std::shared_ptr<NodeObject> result;
+                        auto const obj = seq1_.obj(dist_(gen_));
+                        backend_.fetch(obj->getHash().data(), &result);
+                        suite_.expect(result && isSame(result, obj));
+                    }
+                }
+                catch (std::exception const& e)
+                {
+                    suite_.fail(e.what());
+                }
+            }
+        };
+        try
+        {
+            parallel_for_id<Body>(
+                params.items / fetchBatchSize,
+                params.threads,
+                std::ref(*this),
+                std::ref(params),
+                std::ref(*backend));
+        }
+        catch (std::exception const&)
+        {
+#if NODESTORE_TIMING_DO_VERIFY
+            backend->verify();
+#endif
+            Rethrow();
+        }
+        backend->close();
+    }
+
+    // Fetch the same groups of existing keys with a single fetchBatch call.
+    // The backend is freshly opened so the reads start with cold caches.
+    void
+    do_fetch_batch(
+        Section const& config,
+        Params const& params,
+        beast::Journal journal)
+    {
+        DummyScheduler scheduler;
+        auto backend = make_Backend(config, scheduler, journal);
+        BEAST_EXPECT(backend != nullptr);
+        backend->open();
+
+        class Body
+        {
+        private:
+            suite& suite_;
+            Backend& backend_;
+            Sequence seq1_;
+            beast::xor_shift_engine gen_;
+            std::uniform_int_distribution<std::size_t> dist_;
+
+        public:
+            Body(
+                std::size_t id,
+                suite& s,
+                Params const& params,
+                Backend& backend)
+                : suite_(s)
+                , backend_(backend)
+                , seq1_(1)
+                , gen_(id + 1)
+                , dist_(0, params.items - 1)
+            {
+            }
+
+            void
+            operator()(std::size_t i)
+            {
+                try
+                {
+                    std::vector<std::shared_ptr<NodeObject>> objs;
+                    std::vector<uint256> keys;
+                    std::vector<uint256 const*> hashes;
+                    objs.reserve(fetchBatchSize);
+                    keys.reserve(fetchBatchSize);
+                    hashes.reserve(fetchBatchSize);
+                    for (std::size_t j = 0; j < fetchBatchSize; ++j)
+                    {
+                        objs.push_back(seq1_.obj(dist_(gen_)));
+                        keys.push_back(objs.back()->getHash());
+                        hashes.push_back(&keys.back());
+                    }
+
+                    auto const results = backend_.fetchBatch(hashes).first;
+                    if (!suite_.expect(results.size() == objs.size()))
+                        return;
+                    for (std::size_t j = 0; j < objs.size(); ++j)
+                        suite_.expect(
+                            results[j] && isSame(results[j], objs[j]));
+                }
+                catch (std::exception const& e)
+                {
+                    suite_.fail(e.what());
+                }
+            }
+        };
+        try
+        {
+            parallel_for_id<Body>(
+                params.items / fetchBatchSize,
+                params.threads,
+                std::ref(*this),
+                std::ref(params),
+                std::ref(*backend));
+        }
+        catch (std::exception const&)
+        {
+#if NODESTORE_TIMING_DO_VERIFY
+            backend->verify();
+#endif
+            Rethrow();
+        }
+        backend->close();
+    }
+
     // Perform lookups of non-existent keys
     void
     do_missing(
@@ -758,6 +921,8 @@ public:
         test_list const tests = {
             {"Insert", &Timing_test::do_insert},
             {"Fetch", &Timing_test::do_fetch},
+            {"FetchSeq", &Timing_test::do_fetch_serial},
+            {"FetchBatch", &Timing_test::do_fetch_batch},
             {"Missing", &Timing_test::do_missing},
             {"Mixed", &Timing_test::do_mixed},
             {"Work", &Timing_test::do_work}};
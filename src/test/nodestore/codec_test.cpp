@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/nodestore/TestBase.h>
+#include <xrpld/nodestore/detail/DecodedBlob.h>
+#include <xrpld/nodestore/detail/EncodedBlob.h>
+#include <xrpld/nodestore/detail/codec.h>
+#include <xrpld/shamap/SHAMapInnerNode.h>
+#include <xrpl/protocol/digest.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace ripple {
+namespace NodeStore {
+namespace tests {
+
+namespace {
+
+// An inner node with the given branches set, as the node store holds it
+std::shared_ptr<NodeObject>
+makeInnerNode(std::uint16_t branches, beast::xor_shift_engine& rng)
+{
+    Serializer s;
+    s.add32(HashPrefix::innerNode);
+    for (int i = 0; i < 16; ++i)
+    {
+        uint256 hash;
+        if (branches & (0x8000 >> i))
+            beast::rngfill(hash.begin(), hash.size(), rng);
+        s.addBitString(hash);
+    }
+    return NodeObject::createObject(
+        hotUNKNOWN, std::move(s.modData()), sha512Half(s.slice()));
+}
+
+// Encode an object the way the NuDB backend stores it
+Blob
+compress(std::shared_ptr<NodeObject> const& object)
+{
+    EncodedBlob encoded(object);
+    nudb::detail::buffer bf;
+    auto const result =
+        nodeobject_compress(encoded.getData(), encoded.getSize(), bf);
+    auto const p = static_cast<std::uint8_t const*>(result.first);
+    return Blob(p, p + result.second);
+}
+
+// The decoding that nodeobject_decode replaces
+std::shared_ptr<NodeObject>
+decodeCopying(void const* key, Blob const& value)
+{
+    nudb::detail::buffer bf;
+    auto const result = nodeobject_decompress(value.data(), value.size(), bf);
+    DecodedBlob decoded(key, result.first, result.second);
+    if (!decoded.wasOk())
+        return {};
+    return decoded.createObject();
+}
+
+Batch
+makeObjects(std::size_t count)
+{
+    beast::xor_shift_engine rng(17);
+    auto batch = TestBase::createPredictableBatch(count, 17);
+    for (std::uint16_t branches : {0x8000, 0x0101, 0x7ff7, 0xffff})
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            batch.push_back(makeInnerNode(branches, rng));
+    }
+    return batch;
+}
+
+}  // namespace
+
+class codec_test : public TestBase
+{
+    void
+    testDecode()
+    {
+        testcase("decode");
+
+        for (auto const& object : makeObjects(numObjectsToTest))
+        {
+            auto const value = compress(object);
+            auto const key = object->getHash().data();
+            auto const decoded =
+                nodeobject_decode(key, value.data(), value.size());
+            BEAST_EXPECT(isSame(decoded, object));
+            BEAST_EXPECT(isSame(decodeCopying(key, value), decoded));
+        }
+
+        // The uncompressed format is still read
+        auto const object = makeObjects(1).front();
+        EncodedBlob encoded(object);
+        Blob value{0};
+        value.insert(
+            value.end(),
+            static_cast<std::uint8_t const*>(encoded.getData()),
+            static_cast<std::uint8_t const*>(encoded.getData()) +
+                encoded.getSize());
+        BEAST_EXPECT(isSame(
+            nodeobject_decode(
+                object->getHash().data(), value.data(), value.size()),
+            object));
+
+        // A truncated inner node is rejected
+        auto const inner = compress(makeObjects(1).back());
+        try
+        {
+            nodeobject_decode(
+                object->getHash().data(), inner.data(), inner.size() - 1);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testInnerNode()
+    {
+        testcase("inner node");
+
+        beast::xor_shift_engine rng(23);
+        for (std::uint16_t branches : {0x0000, 0x0001, 0x8421, 0xfffe, 0xffff})
+        {
+            auto const object = makeInnerNode(branches, rng);
+            SHAMapHash const hash{object->getHash()};
+            auto const node = SHAMapTreeNode::makeFromPrefix(
+                makeSlice(object->getData()), hash);
+            auto const inner = std::dynamic_pointer_cast<SHAMapInnerNode>(node);
+            if (!BEAST_EXPECT(inner))
+                continue;
+
+            Serializer s;
+            inner->serializeWithPrefix(s);
+            BEAST_EXPECT(s.modData() == object->getData());
+            for (int i = 0; i < 16; ++i)
+            {
+                BEAST_EXPECT(
+                    inner->isEmptyBranch(i) == !(branches & (0x8000 >> i)));
+            }
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testDecode();
+        testInnerNode();
+    }
+};
+
+// Compares decoding node store values through an intermediate buffer
+// against decoding them directly into their objects.
+class codec_bench_test : public beast::unit_test::suite
+{
+    template <class F>
+    std::chrono::nanoseconds
+    time(std::vector<Blob> const& values, Batch const& objects, F&& f)
+    {
+        using clock = std::chrono::steady_clock;
+        auto const start = clock::now();
+        for (int round = 0; round < 10; ++round)
+        {
+            for (std::size_t i = 0; i < values.size(); ++i)
+                f(objects[i]->getHash().data(), values[i]);
+        }
+        return (clock::now() - start) / (10 * values.size());
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Decode");
+
+        auto const objects = makeObjects(10000);
+        std::vector<Blob> values;
+        for (auto const& object : objects)
+            values.push_back(compress(object));
+
+        std::size_t decoded = 0;
+        auto const copying =
+            time(values, objects, [&](void const* key, Blob const& value) {
+                decoded += decodeCopying(key, value) != nullptr;
+            });
+        auto const direct =
+            time(values, objects, [&](void const* key, Blob const& value) {
+                decoded +=
+                    nodeobject_decode(key, value.data(), value.size()) !=
+                    nullptr;
+            });
+        std::cout << "copying " << copying.count() << "ns, direct "
+                  << direct.count() << "ns per object\n";
+        BEAST_EXPECT(decoded == 20 * values.size());
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(codec, NodeStore, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(codec_bench, NodeStore, ripple);
+
+}  // namespace tests
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <test/jtx.h>
+#include <xrpld/app/misc/HashRouter.h>
+#include <xrpld/app/tx/apply.h>
+#include <xrpld/overlay/detail/BatchVerifier.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class BatchVerifier_test : public beast::unit_test::suite
+{
+    // Counts the continuations called, and waits for them
+    class Calls
+    {
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::size_t count_ = 0;
+
+    public:
+        BatchVerifier::Continuation
+        next()
+        {
+            return [this]() {
+                std::lock_guard lock(mutex_);
+                ++count_;
+                cv_.notify_all();
+            };
+        }
+
+        bool
+        wait(std::size_t n, std::chrono::milliseconds timeout)
+        {
+            std::unique_lock lock(mutex_);
+            return cv_.wait_for(lock, timeout, [&] { return count_ >= n; });
+        }
+
+        std::size_t
+        count()
+        {
+            std::lock_guard lock(mutex_);
+            return count_;
+        }
+    };
+
+    // Payments from alice to bob, each with its own sequence
+    static std::vector<std::shared_ptr<STTx const>>
+    payments(jtx::Env& env, std::size_t n)
+    {
+        using namespace jtx;
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        auto const seq = env.seq("alice");
+        for (std::size_t i = 0; i < n; ++i)
+            txs.push_back(
+                env.jt(pay("alice", "bob", XRP(1)), jtx::seq(seq + i)).stx);
+        return txs;
+    }
+
+    // A copy of a transaction with a changed fee, so its signature is bad
+    static std::shared_ptr<STTx const>
+    tamper(STTx const& tx)
+    {
+        STObject obj(tx);
+        obj.setFieldAmount(sfFee, XRPAmount(tx[sfFee].xrp().drops() + 1));
+
+        Serializer s;
+        obj.add(s);
+        SerialIter sit(s.slice());
+        return std::make_shared<STTx const>(std::ref(sit));
+    }
+
+    void
+    testFlush()
+    {
+        testcase("Batches are closed when full or when the window expires");
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        Env env(*this);
+        env.fund(XRP(10000), "alice", "bob");
+        env.close();
+
+        auto const txs = payments(env, BatchVerifier::maxBatchSize + 3);
+
+        {
+            // A full batch is closed at once, long before the window
+            auto verifier = std::make_shared<BatchVerifier>(
+                env.app(), env.app().getIOService(), 1h, 2);
+            BEAST_EXPECT(verifier->enabled());
+
+            Calls calls;
+            for (std::size_t i = 0; i < BatchVerifier::maxBatchSize; ++i)
+                BEAST_EXPECT(verifier->add(txs[i], calls.next()));
+            BEAST_EXPECT(calls.wait(BatchVerifier::maxBatchSize, 10s));
+            BEAST_EXPECT(verifier->size() == 0);
+            verifier->stop();
+        }
+
+        {
+            // A partial batch is closed when the window expires
+            auto verifier = std::make_shared<BatchVerifier>(
+                env.app(), env.app().getIOService(), 5ms, 2);
+
+            Calls calls;
+            for (std::size_t i = BatchVerifier::maxBatchSize; i < txs.size();
+                 ++i)
+                BEAST_EXPECT(verifier->add(txs[i], calls.next()));
+            BEAST_EXPECT(calls.wait(3, 10s));
+            BEAST_EXPECT(verifier->size() == 0);
+            verifier->stop();
+        }
+
+        {
+            // A window of zero disables batching
+            auto verifier = std::make_shared<BatchVerifier>(
+                env.app(), env.app().getIOService(), 0ms, 2);
+            BEAST_EXPECT(!verifier->enabled());
+
+            Calls calls;
+            BEAST_EXPECT(!verifier->add(txs[0], calls.next()));
+            BEAST_EXPECT(calls.count() == 0);
+        }
+    }
+
+    void
+    testResults()
+    {
+        testcase("Good and bad signatures are cached before continuing");
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        Env env(*this);
+        env.fund(XRP(10000), "alice", "bob");
+        env.close();
+
+        auto const good = payments(env, 2);
+        auto const bad = tamper(*good[1]);
+
+        auto& router = env.app().getHashRouter();
+        auto verifier = std::make_shared<BatchVerifier>(
+            env.app(), env.app().getIOService(), 5ms, 1);
+
+        // Each continuation checks its transaction's result is cached
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t cached = 0;
+        std::size_t called = 0;
+        auto next = [&](std::shared_ptr<STTx const> const& tx) {
+            return [&, tx]() {
+                std::lock_guard lock(mutex);
+                if (router.getFlags(tx->getTransactionID()) != 0)
+                    ++cached;
+                ++called;
+                cv.notify_all();
+            };
+        };
+
+        BEAST_EXPECT(verifier->add(good[0], next(good[0])));
+        BEAST_EXPECT(verifier->add(bad, next(bad)));
+        BEAST_EXPECT(verifier->add(good[1], next(good[1])));
+
+        {
+            std::unique_lock lock(mutex);
+            BEAST_EXPECT(cv.wait_for(lock, 10s, [&] { return called == 3; }));
+            BEAST_EXPECT(cached == 3);
+        }
+
+        auto const& rules = env.current()->rules();
+        auto const& config = env.app().config();
+        BEAST_EXPECT(
+            checkValidity(router, *good[0], rules, config).first ==
+            Validity::Valid);
+        BEAST_EXPECT(
+            checkValidity(router, *bad, rules, config).first ==
+            Validity::SigBad);
+        BEAST_EXPECT(
+            checkValidity(router, *good[1], rules, config).first ==
+            Validity::Valid);
+
+        verifier->stop();
+    }
+
+    void
+    testStop()
+    {
+        testcase("Stopping drops queued transactions");
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        Env env(*this);
+        env.fund(XRP(10000), "alice", "bob");
+        env.close();
+
+        auto const txs = payments(env, 3);
+
+        auto verifier = std::make_shared<BatchVerifier>(
+            env.app(), env.app().getIOService(), 1h, 1);
+
+        Calls calls;
+        for (auto const& tx : txs)
+            BEAST_EXPECT(verifier->add(tx, calls.next()));
+        BEAST_EXPECT(verifier->size() == txs.size());
+
+        verifier->stop();
+        BEAST_EXPECT(verifier->size() == 0);
+        BEAST_EXPECT(!verifier->add(txs[0], calls.next()));
+
+        // The cancelled timer must not close the dropped batch, even
+        // after the verifier is gone
+        verifier.reset();
+        BEAST_EXPECT(!calls.wait(1, 100ms));
+        BEAST_EXPECT(calls.count() == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFlush();
+        testResults();
+        testStop();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BatchVerifier, overlay, ripple);
+
+}  // namespace test
+}  // namespace ripple
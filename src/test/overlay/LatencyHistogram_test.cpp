@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/overlay/detail/LatencyHistogram.h>
+#include <xrpl/beast/unit_test.h>
+
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class LatencyHistogram_test : public beast::unit_test::suite
+{
+    using ms = std::chrono::milliseconds;
+
+    void
+    testPercentiles()
+    {
+        testcase("Percentiles");
+
+        LatencyHistogram<ms> h;
+        BEAST_EXPECT(h.count() == 0);
+        BEAST_EXPECT(h.percentile(50) == ms{0});
+        BEAST_EXPECT(h.max() == ms{0});
+
+        // 98 fast samples and two slow ones
+        for (int i = 0; i < 98; ++i)
+            h.add(ms{10});
+        h.add(ms{900});
+        h.add(ms{1000});
+
+        BEAST_EXPECT(h.count() == 100);
+        BEAST_EXPECT(h.total() == ms{98 * 10 + 1900});
+        BEAST_EXPECT(h.max() == ms{1000});
+
+        // 10 falls in the bucket from 8 to 15, and 900 in the one from 512
+        // to 1023
+        BEAST_EXPECT(h.percentile(50) == ms{15});
+        BEAST_EXPECT(h.percentile(98) == ms{15});
+        BEAST_EXPECT(h.percentile(99) == ms{1000});
+        BEAST_EXPECT(h.percentile(100) == ms{1000});
+
+        // Zero and negative durations count as zero
+        LatencyHistogram<ms> z;
+        z.add(ms{0});
+        z.add(ms{-5});
+        BEAST_EXPECT(z.count() == 2);
+        BEAST_EXPECT(z.percentile(99) == ms{0});
+
+        auto const json = h.json();
+        BEAST_EXPECT(json[jss::count] == "100");
+        BEAST_EXPECT(json[jss::p50] == "15");
+        BEAST_EXPECT(json[jss::p99] == "1000");
+        BEAST_EXPECT(json[jss::max] == "1000");
+    }
+
+    void
+    testConcurrent()
+    {
+        testcase("Concurrent");
+
+        LatencyHistogram<ms> h;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&h, t]() {
+                for (int i = 0; i < 10000; ++i)
+                    h.add(ms{t * 10000 + i});
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        BEAST_EXPECT(h.count() == 40000);
+        BEAST_EXPECT(h.max() == ms{39999});
+    }
+
+public:
+    void
+    run() override
+    {
+        testPercentiles();
+        testConcurrent();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LatencyHistogram, overlay, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/overlay/Message.h>
+#include <xrpld/overlay/detail/ProtocolMessage.h>
+#include <xrpl/beast/unit_test.h>
+#include <xrpl/beast/xor_shift_engine.h>
+#include <xrpl/protocol/messages.h>
+
+#include <boost/asio/buffer.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+std::string
+randomBytes(beast::xor_shift_engine& rng, std::size_t n)
+{
+    std::string s(n, '\0');
+    for (auto& c : s)
+        c = static_cast<char>(rng());
+    return s;
+}
+
+// Messages shaped like the ones peers exchange most, with the field sizes
+// seen on the network.
+std::shared_ptr<protocol::TMLedgerData>
+makeLedgerData(beast::xor_shift_engine& rng, int nodes)
+{
+    auto m = std::make_shared<protocol::TMLedgerData>();
+    m->set_ledgerhash(randomBytes(rng, 32));
+    m->set_ledgerseq(88'000'000);
+    m->set_type(protocol::liAS_NODE);
+    for (int i = 0; i < nodes; ++i)
+    {
+        auto node = m->add_nodes();
+        // Alternate inner nodes and account state leaves
+        node->set_nodedata(randomBytes(rng, i % 2 ? 516 : 160));
+        node->set_nodeid(randomBytes(rng, 33));
+    }
+    return m;
+}
+
+std::shared_ptr<protocol::TMTransactions>
+makeTransactions(beast::xor_shift_engine& rng, int txns)
+{
+    auto m = std::make_shared<protocol::TMTransactions>();
+    for (int i = 0; i < txns; ++i)
+    {
+        auto tx = m->add_transactions();
+        tx->set_rawtransaction(randomBytes(rng, 250));
+        tx->set_status(protocol::tsNEW);
+        tx->set_receivetimestamp(i);
+    }
+    return m;
+}
+
+std::shared_ptr<protocol::TMGetObjectByHash>
+makeObjects(beast::xor_shift_engine& rng, int objects)
+{
+    auto m = std::make_shared<protocol::TMGetObjectByHash>();
+    m->set_type(protocol::TMGetObjectByHash::otSTATE_NODE);
+    m->set_query(false);
+    for (int i = 0; i < objects; ++i)
+    {
+        auto obj = m->add_objects();
+        obj->set_hash(randomBytes(rng, 32));
+        obj->set_data(randomBytes(rng, 300));
+        obj->set_ledgerseq(88'000'000);
+    }
+    return m;
+}
+
+std::shared_ptr<protocol::TMValidation>
+makeValidation(beast::xor_shift_engine& rng)
+{
+    auto m = std::make_shared<protocol::TMValidation>();
+    m->set_validation(randomBytes(rng, 250));
+    return m;
+}
+
+// The serialized message, with its header, as it arrives from a peer
+std::vector<std::uint8_t>
+wire(::google::protobuf::Message const& m, int type)
+{
+    return Message(m, type).getBuffer(compression::Compressed::Off);
+}
+
+template <class T>
+std::shared_ptr<T>
+parse(std::vector<std::uint8_t> const& buffer)
+{
+    auto const buffers = boost::asio::buffer(buffer);
+    boost::system::error_code ec;
+    auto const header =
+        detail::parseMessageHeader(ec, buffers, buffer.size());
+    if (!header)
+        return {};
+    return detail::parseMessageContent<T>(*header, buffers);
+}
+
+}  // namespace
+
+class ProtocolMessage_test : public beast::unit_test::suite
+{
+    void
+    testArena()
+    {
+        testcase("Arena parsing");
+
+        beast::xor_shift_engine rng(42);
+        auto const data = makeLedgerData(rng, 100);
+        auto const buffer = wire(*data, protocol::mtLEDGER_DATA);
+
+        std::weak_ptr<protocol::TMLedgerData> weak;
+        {
+            auto const m = parse<protocol::TMLedgerData>(buffer);
+            BEAST_EXPECT(m && m->GetArena() != nullptr);
+            BEAST_EXPECT(
+                m && m->SerializeAsString() == data->SerializeAsString());
+
+            // Parts of the message outlive the reference to the message
+            // as long as something shares ownership of it.
+            if (m)
+            {
+                auto const& node = m->nodes(50);
+                std::shared_ptr<protocol::TMLedgerNode const> const part(
+                    m, &node);
+                weak = m;
+                BEAST_EXPECT(part->nodedata() == data->nodes(50).nodedata());
+            }
+        }
+        BEAST_EXPECT(weak.expired());
+
+        // A copy of an arena message is an ordinary message
+        auto const m = parse<protocol::TMLedgerData>(buffer);
+        if (BEAST_EXPECT(m))
+        {
+            protocol::TMLedgerData copy(*m);
+            BEAST_EXPECT(copy.GetArena() == nullptr);
+            BEAST_EXPECT(copy.nodes_size() == 100);
+        }
+
+        // Small messages are parsed onto the heap
+        auto const small = parse<protocol::TMValidation>(
+            wire(*makeValidation(rng), protocol::mtVALIDATION));
+        BEAST_EXPECT(small && small->GetArena() == nullptr);
+
+        // A bad payload still fails to parse
+        auto bad = buffer;
+        bad.resize(bad.size() - 10);
+        BEAST_EXPECT(!parse<protocol::TMLedgerData>(bad));
+    }
+
+public:
+    void
+    run() override
+    {
+        testArena();
+    }
+};
+
+// Compares parsing inbound messages onto the heap, as messages used to be
+// parsed, against parsing them into an arena.
+class ProtocolMessageBench_test : public beast::unit_test::suite
+{
+    template <class T>
+    void
+    bench(std::string const& name, std::shared_ptr<T> const& m, int type)
+    {
+        using clock = std::chrono::steady_clock;
+        auto const buffer = wire(*m, type);
+        auto const payload = buffer.data() + compression::headerBytes;
+        auto const payloadSize = buffer.size() - compression::headerBytes;
+        int const rounds = std::max<int>(100, 50'000'000 / buffer.size());
+
+        std::size_t parsed = 0;
+        auto start = clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto const heap = std::make_shared<T>();
+            parsed += heap->ParseFromArray(payload, payloadSize);
+        }
+        auto const heapTime = clock::now() - start;
+
+        std::size_t arenaBytes = 0;
+        start = clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto const arena = parse<T>(buffer);
+            parsed += arena != nullptr;
+            if (auto const a = arena->GetArena())
+                arenaBytes = a->SpaceAllocated();
+        }
+        auto const arenaTime = clock::now() - start;
+
+        using ns = std::chrono::nanoseconds;
+        std::cout << name << " (" << buffer.size() << " bytes): heap "
+                  << std::chrono::duration_cast<ns>(heapTime).count() / rounds
+                  << "ns, arena "
+                  << std::chrono::duration_cast<ns>(arenaTime).count() / rounds
+                  << "ns, " << arenaBytes << " arena bytes\n";
+        BEAST_EXPECT(parsed == 2 * rounds);
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Parse");
+
+        beast::xor_shift_engine rng(42);
+        bench(
+            "TMLedgerData", makeLedgerData(rng, 1000), protocol::mtLEDGER_DATA);
+        bench(
+            "TMTransactions",
+            makeTransactions(rng, 100),
+            protocol::mtTRANSACTIONS);
+        bench(
+            "TMGetObjectByHash",
+            makeObjects(rng, 256),
+            protocol::mtGET_OBJECTS);
+        bench("TMValidation", makeValidation(rng), protocol::mtVALIDATION);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ProtocolMessage, overlay, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(ProtocolMessageBench, overlay, ripple);
+
+}  // namespace test
+}  // namespace ripple
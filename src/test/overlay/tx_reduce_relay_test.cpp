@@ -125,6 +125,7 @@ private:
         send(std::shared_ptr<Message> const&) override
         {
             sendTx_++;
+            sent_ = true;
         }
         void
         addTxQueue(const uint256& hash) override
@@ -141,6 +142,7 @@ private:
         inline static std::size_t sid_ = 0;
         inline static std::uint16_t queueTx_ = 0;
         inline static std::uint16_t sendTx_ = 0;
+        bool sent_ = false;
     };
 
     std::uint16_t lid_{0};
@@ -229,6 +231,45 @@ private:
             PeerTest::queueTx_ == expectQueue);
     }
 
+    void
+    testRelaySources()
+    {
+        testcase("relay sources");
+        jtx::Env env(*this);
+        std::vector<std::shared_ptr<PeerTest>> peers;
+        env.app().config().TX_REDUCE_RELAY_ENABLE = true;
+        env.app().config().TX_REDUCE_RELAY_MIN_PEERS = 20;
+        env.app().config().TX_RELAY_PERCENTAGE = 25;
+        PeerTest::init();
+        lid_ = 0;
+        rid_ = 0;
+        std::uint16_t nDisabled = 0;
+        for (int i = 0; i < 60; i++)
+            addPeer(env, peers, nDisabled);
+
+        // Half of the peers usually relay transactions to us first, the
+        // other half only relay ones we already have.
+        for (std::size_t i = 0; i < peers.size(); ++i)
+        {
+            for (int j = 0; j < 100; ++j)
+                peers[i]->countRelayedTx(i % 2 == 0 || j == 0);
+        }
+        BEAST_EXPECT(peers[0]->txFirstShare() == 1000);
+        BEAST_EXPECT(peers[1]->txFirstShare() == 10);
+
+        protocol::TMTransaction m;
+        m.set_rawtransaction("transaction");
+        m.set_deferred(false);
+        m.set_status(protocol::TransactionStatus::tsNEW);
+        env.app().overlay().relay(uint256{0}, m, {});
+
+        // 20 + 25% of 40 peers get the transaction, all of them from the
+        // half that does not have it yet
+        BEAST_EXPECT(PeerTest::sendTx_ == 30 && PeerTest::queueTx_ == 30);
+        for (std::size_t i = 0; i < peers.size(); ++i)
+            BEAST_EXPECT(peers[i]->sent_ == (i % 2 == 1));
+    }
+
     void
     run() override
     {
@@ -267,6 +308,7 @@ private:
         // towards relayed (20-14=6)
         skip = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
         testRelay("disabled & skip, no relay", true, 20, 2, 10, 25, 0, 6, skip);
+        testRelaySources();
     }
 };
 
@@ -21,11 +21,14 @@
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/json/json_reader.h>
 #include <xrpl/json/to_string.h>
+#include <xrpl/protocol/Indexes.h>
 #include <xrpl/protocol/SecretKey.h>
 #include <xrpl/protocol/jss.h>
 #include <xrpl/protocol/st.h>
 
 #include <array>
+#include <chrono>
+#include <iostream>
 #include <memory>
 #include <type_traits>
 
@@ -714,6 +717,89 @@ run() override
 }
 ;
 
+// Times the field accessors transactors use most, on objects with and
+// without a template.
+class STObjectBench_test : public beast::unit_test::suite
+{
+    template <class F>
+    void
+    bench(std::string const& name, F&& accessFour)
+    {
+        using clock = std::chrono::steady_clock;
+        int const rounds = 5'000'000;
+
+        std::uint64_t sum = 0;
+        auto const start = clock::now();
+        for (int i = 0; i < rounds; ++i)
+            sum += accessFour();
+        auto const elapsed = clock::now() - start;
+
+        using ns = std::chrono::duration<double, std::nano>;
+        auto const perAccess =
+            std::chrono::duration_cast<ns>(elapsed).count() / (4 * rounds);
+        std::cout << name << ": " << perAccess << "ns per access\n";
+        BEAST_EXPECT(sum != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Field lookup");
+
+        AccountID const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+        AccountID const bob = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("bob")).first);
+
+        // The fields Payment::doApply reads, on a transaction
+        STTx const tx(ttPAYMENT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, alice);
+            obj.setAccountID(sfDestination, bob);
+            obj.setFieldAmount(sfAmount, XRPAmount(1000));
+            obj.setFieldAmount(sfFee, XRPAmount(10));
+            obj.setFieldU32(sfSequence, 7);
+        });
+        bench("STTx", [&]() -> std::uint64_t {
+            return tx.getFieldU32(sfSequence) +
+                tx.getAccountID(sfDestination).data()[0] +
+                tx.getFieldAmount(sfAmount).mantissa() +
+                tx.isFieldPresent(sfDestinationTag);
+        });
+
+        // ... on the account root it modifies
+        SLE sle(keylet::account(alice));
+        sle.setAccountID(sfAccount, alice);
+        sle.setFieldAmount(sfBalance, XRPAmount(100000));
+        sle.setFieldU32(sfSequence, 7);
+        sle.setFieldU32(sfOwnerCount, 1);
+        bench("SLE", [&]() -> std::uint64_t {
+            return sle.getFieldU32(sfSequence) +
+                sle.getFieldU32(sfOwnerCount) +
+                sle.getFieldAmount(sfBalance).mantissa() +
+                sle.isFieldPresent(sfRegularKey);
+        });
+
+        // ... and on an object without a template, like those in metadata
+        STObject free(sfFinalFields);
+        free.setAccountID(sfAccount, alice);
+        free.setFieldAmount(sfBalance, XRPAmount(100000));
+        free.setFieldU32(sfFlags, 0);
+        free.setFieldU32(sfOwnerCount, 1);
+        free.setFieldH256(sfPreviousTxnID, uint256{1});
+        free.setFieldU32(sfPreviousTxnLgrSeq, 5);
+        free.setFieldU32(sfSequence, 7);
+        free.setFieldU64(sfOwnerNode, 3);
+        bench("No template", [&]() -> std::uint64_t {
+            return free.getFieldU32(sfSequence) +
+                free.getFieldU32(sfOwnerCount) +
+                free.getFieldAmount(sfBalance).mantissa() +
+                free.isFieldPresent(sfRegularKey);
+        });
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(STObject, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectBench, protocol, ripple);
 
 }  // ripple
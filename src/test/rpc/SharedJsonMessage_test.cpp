@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/net/InfoSub.h>
+#include <xrpl/beast/unit_test.h>
+#include <xrpl/json/json_writer.h>
+#include <xrpl/protocol/jss.h>
+#include <xrpl/server/WSSession.h>
+
+#include <boost/beast/core/multi_buffer.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace ripple::test {
+
+namespace {
+
+// A transaction stream message of a typical size
+Json::Value
+makeMessage()
+{
+    Json::Value jv(Json::objectValue);
+    jv[jss::type] = "transaction";
+    jv[jss::engine_result] = "tesSUCCESS";
+    jv[jss::engine_result_code] = 0;
+    jv[jss::ledger_index] = 88'000'000;
+    jv[jss::validated] = true;
+
+    auto& tx = jv[jss::transaction] = Json::objectValue;
+    tx[jss::Account] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+    tx[jss::Destination] = "rPT1Sjq2YGrBMTttX4GZHjKu9dyfzbpAYe";
+    tx[jss::Amount] = "1000000";
+    tx[jss::Fee] = "12";
+    tx[jss::Sequence] = 42;
+    tx[jss::TransactionType] = "Payment";
+    tx[jss::SigningPubKey] = std::string(66, 'A');
+    tx[jss::TxnSignature] = std::string(140, 'B');
+
+    auto& meta = jv[jss::meta] = Json::objectValue;
+    auto& nodes = meta["AffectedNodes"] = Json::arrayValue;
+    for (int i = 0; i < 4; ++i)
+    {
+        Json::Value node(Json::objectValue);
+        auto& modified = node["ModifiedNode"] = Json::objectValue;
+        modified["LedgerEntryType"] = "AccountRoot";
+        modified["LedgerIndex"] = std::string(64, '0' + i);
+        modified["FinalFields"]["Balance"] = std::to_string(i * 1000);
+        modified["PreviousFields"]["Balance"] = std::to_string(i);
+        nodes.append(std::move(node));
+    }
+    meta["TransactionResult"] = "tesSUCCESS";
+    return jv;
+}
+
+// Drain a message the way a websocket session writes it
+std::string
+drain(WSMsg& m, std::size_t chunk)
+{
+    std::string out;
+    for (;;)
+    {
+        auto const [done, buffers] = m.prepare(chunk, {});
+        for (auto const& b : buffers)
+            out.append(static_cast<char const*>(b.data()), b.size());
+        if (done)
+            break;
+    }
+    return out;
+}
+
+std::shared_ptr<WSMsg>
+makeStreambufMsg(Json::Value const& jv)
+{
+    boost::beast::multi_buffer sb;
+    Json::stream(jv, [&](void const* data, std::size_t n) {
+        sb.commit(boost::asio::buffer_copy(
+            sb.prepare(n), boost::asio::buffer(data, n)));
+    });
+    return std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
+}
+
+}  // namespace
+
+class SharedJsonMessage_test : public beast::unit_test::suite
+{
+    void
+    testSharedMessage()
+    {
+        testcase("Shared message");
+
+        auto const jv = makeMessage();
+        SharedJsonMessage const msg{jv};
+        BEAST_EXPECT(&msg.json() == &jv);
+
+        // The text is built once and reused
+        auto const& text = msg.text();
+        BEAST_EXPECT(text && *text == drain(*makeStreambufMsg(jv), 4096));
+        BEAST_EXPECT(msg.text().get() == text.get());
+
+        // Every session sees the same bytes as an unshared message
+        for (std::size_t chunk : {1, 7, 100, 4096})
+        {
+            SharedWSMsg a{text};
+            SharedWSMsg b{text};
+            auto const expected = drain(*makeStreambufMsg(jv), chunk);
+            BEAST_EXPECT(drain(a, chunk) == expected);
+            BEAST_EXPECT(drain(b, chunk) == expected);
+        }
+
+        // An empty message is done immediately
+        SharedWSMsg empty{std::make_shared<std::string const>()};
+        auto const [done, buffers] = empty.prepare(100, {});
+        BEAST_EXPECT(done && buffers.empty());
+    }
+
+public:
+    void
+    run() override
+    {
+        testSharedMessage();
+    }
+};
+
+// Compares serializing a published message for each subscriber against
+// serializing it once and sharing the buffer.
+class SharedJsonMessageBench_test : public beast::unit_test::suite
+{
+    template <class F>
+    std::chrono::microseconds
+    time(int rounds, F&& f)
+    {
+        using clock = std::chrono::steady_clock;
+        auto const start = clock::now();
+        for (int i = 0; i < rounds; ++i)
+            f();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   clock::now() - start) /
+            rounds;
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Subscription fan-out");
+
+        auto const jv = makeMessage();
+        std::size_t bytes = 0;
+        for (int subscribers : {10, 100, 1000, 5000})
+        {
+            auto const perSub = time(20, [&] {
+                for (int i = 0; i < subscribers; ++i)
+                    bytes += drain(*makeStreambufMsg(jv), 4096).size();
+            });
+            auto const shared = time(20, [&] {
+                SharedJsonMessage const msg{jv};
+                for (int i = 0; i < subscribers; ++i)
+                {
+                    SharedWSMsg m{msg.text()};
+                    bytes += drain(m, 4096).size();
+                }
+            });
+            std::cout << subscribers << " subscribers: per-subscriber "
+                      << perSub.count() << "us, shared " << shared.count()
+                      << "us\n";
+        }
+        BEAST_EXPECT(bytes != 0);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SharedJsonMessage, rpc, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SharedJsonMessageBench, rpc, ripple);
+
+}  // namespace ripple::test
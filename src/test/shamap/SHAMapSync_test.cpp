@@ -26,6 +26,11 @@
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/beast/xor_shift_engine.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
 namespace ripple {
 namespace tests {
 
@@ -112,10 +117,62 @@ public:
         source.visitLeaves([&count](auto const& item) { ++count; });
         BEAST_EXPECT(count == items);
 
+        count = 0;
+        source.visitLeavesPrefetch([&count](auto const& item) { ++count; });
+        BEAST_EXPECT(count == items);
+
         std::vector<SHAMapMissingNode> missingNodes;
         source.walkMap(missingNodes, 2048);
         BEAST_EXPECT(missingNodes.empty());
 
+        {
+            // Walk a map whose nodes must all be read back from the database
+            TestNodeFamily f3(journal);
+            SHAMap stored(SHAMapType::FREE, f3);
+            for (int i = 0; i < 1000; ++i)
+                stored.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeRandomAS());
+            stored.flushDirty(hotACCOUNT_NODE);
+
+            int storedNodes = 0;
+            stored.visitNodes([&storedNodes](SHAMapTreeNode&) {
+                ++storedNodes;
+                return true;
+            });
+
+            f3.reset();
+            SHAMap loaded(SHAMapType::FREE, stored.getHash().as_uint256(), f3);
+            BEAST_EXPECT(loaded.fetchRoot(stored.getHash(), nullptr));
+
+            int loadedNodes = 0;
+            loaded.visitNodesPrefetch([&loadedNodes](SHAMapTreeNode&) {
+                ++loadedNodes;
+                return true;
+            });
+            BEAST_EXPECT(loadedNodes == storedNodes);
+
+            missingNodes.clear();
+            loaded.walkMap(missingNodes, 2048);
+            BEAST_EXPECT(missingNodes.empty());
+
+            // Nodes that aren't read because the database is stopping are
+            // not reported as missing, and the walks end without an error
+            f3.reset();
+            SHAMap unread(SHAMapType::FREE, stored.getHash().as_uint256(), f3);
+            BEAST_EXPECT(unread.fetchRoot(stored.getHash(), nullptr));
+            f3.db().stop();
+
+            missingNodes.clear();
+            unread.walkMap(missingNodes, 2048);
+            BEAST_EXPECT(missingNodes.empty());
+
+            int unreadNodes = 0;
+            unread.visitNodesPrefetch([&unreadNodes](SHAMapTreeNode&) {
+                ++unreadNodes;
+                return true;
+            });
+            BEAST_EXPECT(unreadNodes == 1);
+        }
+
         std::vector<SHAMapNodeID> nodeIDs, gotNodeIDs;
         std::vector<Blob> gotNodes;
         std::vector<uint256> hashes;
@@ -135,6 +192,31 @@ public:
                     .addRootNode(
                         source.getHash(), makeSlice(a[0].second), nullptr)
                     .isGood());
+
+            // Searching the branches of the root one at a time finds each
+            // missing node exactly once
+            auto const all = destination.getMissingNodes(256, nullptr);
+            std::size_t found = 0;
+            bool inBranch = true;
+            for (unsigned b = 0; b < SHAMap::branchFactor; ++b)
+            {
+                SHAMap::RootBranches branches;
+                branches.set(b);
+                auto const some =
+                    destination.getMissingNodes(256, nullptr, branches);
+                found += some.size();
+                for (auto const& [id, hash] : some)
+                    inBranch &= selectBranch({}, id.getNodeID()) == b;
+            }
+            BEAST_EXPECT(!all.empty() && found == all.size() && inBranch);
+            BEAST_EXPECT(destination.isSynching());
+
+            // A node that could not be made from its wire format is invalid
+            auto const missing = destination.getMissingNodes(1, nullptr);
+            BEAST_EXPECT(
+                missing.size() == 1 &&
+                destination.addKnownNode(missing[0].first, nullptr, nullptr)
+                    .isInvalid());
         }
 
         do
@@ -168,13 +250,20 @@ public:
 
             for (std::size_t i = 0; i < b.size(); ++i)
             {
+                // Add some nodes from their wire format and some already
+                // made from it.
+                auto const added = (i % 2 == 0)
+                    ? destination.addKnownNode(
+                          b[i].first, makeSlice(b[i].second), nullptr)
+                    : destination.addKnownNode(
+                          b[i].first,
+                          SHAMapTreeNode::makeFromWire(makeSlice(b[i].second)),
+                          nullptr);
+
                 // Don't use BEAST_EXPECT here b/c it will be called a
                 // non-deterministic number of times and the number of tests run
                 // should be deterministic
-                if (!destination
-                         .addKnownNode(
-                             b[i].first, makeSlice(b[i].second), nullptr)
-                         .isUseful())
+                if (!added.isUseful())
                     fail("", __FILE__, __LINE__);
             }
         } while (true);
@@ -187,7 +276,140 @@ public:
     }
 };
 
+// Replays the node batches of a full sync, as a peer would send them in
+// TMLedgerData replies, into an empty map. Compares making each node from
+// its wire format while adding it, as replies used to be processed, with
+// making the nodes of a batch on several threads first.
+class SHAMapSyncBench_test : public beast::unit_test::suite
+{
+    beast::xor_shift_engine eng_;
+
+    using Batch = std::vector<std::pair<SHAMapNodeID, Blob>>;
+
+    boost::intrusive_ptr<SHAMapItem>
+    makeItem()
+    {
+        // About the size of an account root
+        Serializer s;
+        for (int d = 0; d < 30; ++d)
+            s.add32(rand_int<std::uint32_t>(eng_));
+        return make_shamapitem(s.getSHA512Half(), s.slice());
+    }
+
+    // Record the batches a peer would send while we sync the map
+    std::vector<Batch>
+    record(SHAMap& source, beast::Journal journal)
+    {
+        TestNodeFamily f(journal);
+        SHAMap destination(SHAMapType::FREE, f);
+        destination.setSynching();
+
+        std::vector<Batch> batches(1);
+        source.getNodeFat(SHAMapNodeID(), batches.back(), false, 0);
+        destination.addRootNode(
+            source.getHash(), makeSlice(batches.back()[0].second), nullptr);
+
+        while (true)
+        {
+            auto const missing = destination.getMissingNodes(256, nullptr);
+            if (missing.empty())
+                break;
+
+            Batch batch;
+            for (auto const& m : missing)
+                source.getNodeFat(m.first, batch, false, 2);
+            for (auto const& [id, data] : batch)
+                destination.addKnownNode(id, makeSlice(data), nullptr);
+            batches.push_back(std::move(batch));
+        }
+        return batches;
+    }
+
+    void
+    replay(
+        std::vector<Batch> const& batches,
+        SHAMapHash const& rootHash,
+        std::size_t threads,
+        beast::Journal journal)
+    {
+        using clock = std::chrono::steady_clock;
+        TestNodeFamily f(journal);
+        SHAMap destination(SHAMapType::FREE, f);
+        destination.setSynching();
+        destination.addRootNode(
+            rootHash, makeSlice(batches[0][0].second), nullptr);
+
+        std::size_t nodes = 0;
+        clock::duration making{};
+        auto const start = clock::now();
+        for (std::size_t b = 1; b < batches.size(); ++b)
+        {
+            auto const& batch = batches[b];
+            nodes += batch.size();
+            if (threads == 0)
+            {
+                for (auto const& [id, data] : batch)
+                    destination.addKnownNode(id, makeSlice(data), nullptr);
+                continue;
+            }
+
+            auto const makeStart = clock::now();
+            std::vector<std::shared_ptr<SHAMapTreeNode>> made(batch.size());
+            std::atomic<std::size_t> next{0};
+            auto make = [&]() {
+                for (auto i = next++; i < batch.size(); i = next++)
+                    made[i] = SHAMapTreeNode::makeFromWire(
+                        makeSlice(batch[i].second));
+            };
+            std::vector<std::thread> workers;
+            for (std::size_t t = 1; t < threads; ++t)
+                workers.emplace_back(make);
+            make();
+            for (auto& w : workers)
+                w.join();
+            making += clock::now() - makeStart;
+
+            for (std::size_t i = 0; i < batch.size(); ++i)
+                destination.addKnownNode(
+                    batch[i].first, std::move(made[i]), nullptr);
+        }
+        auto const elapsed = clock::now() - start;
+
+        destination.clearSynching();
+        BEAST_EXPECT(destination.getHash() == rootHash);
+
+        using ms = std::chrono::milliseconds;
+        std::cout << (threads ? std::to_string(threads) + " threads"
+                              : std::string("serial"))
+                  << ": " << nodes << " nodes in "
+                  << std::chrono::duration_cast<ms>(elapsed).count()
+                  << "ms, making nodes "
+                  << std::chrono::duration_cast<ms>(making).count() << "ms\n";
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Replay");
+
+        using namespace beast::severities;
+        test::SuiteJournal journal("SHAMapSyncBench_test", *this);
+
+        TestNodeFamily f(journal);
+        SHAMap source(SHAMapType::FREE, f);
+        for (int i = 0; i < 200'000; ++i)
+            source.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem());
+        source.setImmutable();
+
+        auto const batches = record(source, journal);
+        for (std::size_t threads : {0, 1, 2, 4, 8})
+            replay(batches, source.getHash(), threads, journal);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(SHAMapSync, shamap, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapSyncBench, shamap, ripple);
 
 }  // namespace tests
 }  // namespace ripple
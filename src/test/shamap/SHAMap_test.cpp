@@ -24,6 +24,10 @@
 #include <xrpl/basics/Buffer.h>
 #include <xrpl/beast/unit_test.h>
 #include <xrpl/beast/utility/Journal.h>
+#include <xrpl/protocol/digest.h>
+
+#include <chrono>
+#include <iostream>
 
 namespace ripple {
 namespace tests {
@@ -122,6 +126,71 @@ public:
 
         run(true, journal);
         run(false, journal);
+        testParallelFlush(journal);
+    }
+
+    static boost::intrusive_ptr<SHAMapItem>
+    makeItem(std::uint32_t i, std::uint32_t version)
+    {
+        auto const key = sha512Half(i);
+        auto const data = sha512Half(i, version);
+        return make_shamapitem(key, Slice{data.data(), data.size()});
+    }
+
+    void
+    testParallelFlush(beast::Journal const& journal)
+    {
+        testcase("parallel flush");
+
+        TestNodeFamily f1(journal), f2(journal);
+        SHAMap serial(SHAMapType::FREE, f1);
+        SHAMap parallel(SHAMapType::FREE, f2);
+
+        // Enough items that the branches of the root are flushed on
+        // several threads
+        for (std::uint32_t i = 0; i < 5000; ++i)
+        {
+            serial.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 0));
+            parallel.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 0));
+        }
+
+        auto flushed = serial.flushDirty(hotACCOUNT_NODE, false);
+        BEAST_EXPECT(parallel.flushDirty(hotACCOUNT_NODE) == flushed);
+        BEAST_EXPECT(parallel.getHash() == serial.getHash());
+        parallel.invariants();
+
+        // Modify a map that shares its nodes with a snapshot
+        auto const snapshot = parallel.snapShot(false);
+        auto const before = parallel.getHash();
+        for (std::uint32_t i = 0; i < 5000; i += 2)
+        {
+            serial.updateGiveItem(
+                SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 1));
+            parallel.updateGiveItem(
+                SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 1));
+        }
+        for (std::uint32_t i = 5000; i < 6000; ++i)
+        {
+            serial.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 0));
+            parallel.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeItem(i, 0));
+        }
+
+        flushed = serial.flushDirty(hotACCOUNT_NODE, false);
+        BEAST_EXPECT(parallel.flushDirty(hotACCOUNT_NODE) == flushed);
+        BEAST_EXPECT(parallel.getHash() == serial.getHash());
+        BEAST_EXPECT(parallel.getHash() != before);
+        BEAST_EXPECT(snapshot->getHash() == before);
+        parallel.invariants();
+        snapshot->invariants();
+
+        // Every node was written to the store
+        f2.reset();
+        SHAMap loaded(SHAMapType::FREE, parallel.getHash().as_uint256(), f2);
+        BEAST_EXPECT(loaded.fetchRoot(parallel.getHash(), nullptr));
+        std::vector<SHAMapMissingNode> missing;
+        loaded.walkMap(missing, 32);
+        BEAST_EXPECT(missing.empty());
+        BEAST_EXPECT(loaded.deepCompare(parallel));
     }
 
     void
@@ -400,7 +469,57 @@ class SHAMapPathProof_test : public beast::unit_test::suite
     }
 };
 
+// Times flushing a map after a large ledger modified many of its leaves,
+// on one thread and with the branches of the root flushed in parallel.
+class SHAMapFlushBench_test : public beast::unit_test::suite
+{
+    void
+    run() override
+    {
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::milliseconds;
+        test::SuiteJournal journal("SHAMapFlushBench_test", *this);
+        testcase("Flush");
+
+        TestNodeFamily f(journal);
+        SHAMap base(SHAMapType::FREE, f);
+        for (std::uint32_t i = 0; i < 500'000; ++i)
+        {
+            base.addItem(
+                SHAMapNodeType::tnACCOUNT_STATE, SHAMap_test::makeItem(i, 0));
+        }
+        base.flushDirty(hotACCOUNT_NODE);
+        base.setImmutable();
+
+        SHAMapHash hash;
+        for (bool const parallel : {false, true})
+        {
+            // Modify 100k leaves of the map, as closing a ledger would
+            auto const map = base.snapShot(true);
+            for (std::uint32_t i = 0; i < 500'000; i += 5)
+            {
+                map->updateGiveItem(
+                    SHAMapNodeType::tnACCOUNT_STATE,
+                    SHAMap_test::makeItem(i, 1));
+            }
+
+            auto const start = clock::now();
+            auto const flushed = map->flushDirty(hotACCOUNT_NODE, parallel);
+            auto const elapsed = clock::now() - start;
+
+            std::cout << (parallel ? "parallel: " : "serial: ") << flushed
+                      << " nodes in "
+                      << std::chrono::duration_cast<ms>(elapsed).count()
+                      << "ms\n";
+
+            BEAST_EXPECT(!parallel || map->getHash() == hash);
+            hash = map->getHash();
+        }
+    }
+};
+
 BEAST_DEFINE_TESTSUITE(SHAMap, ripple_app, ripple);
 BEAST_DEFINE_TESTSUITE(SHAMapPathProof, ripple_app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapFlushBench, ripple_app, ripple);
 }  // namespace tests
 }  // namespace ripple
@@ -39,6 +39,9 @@ class SHAMap;
     Build a new ledger by applying a set of transactions accepted as part of
     consensus.
 
+    With more than one ledger build worker configured, transactions are
+    applied speculatively in parallel. The ledger built is the same.
+
     @param parent The ledger to apply transactions to
     @param closeTime The time the ledger closed
     @param closeTimeCorrect Whether consensus agreed on close time
@@ -25,6 +25,7 @@
 #include <xrpld/app/main/Application.h>
 #include <xrpld/overlay/PeerSet.h>
 #include <xrpl/basics/CountedObject.h>
+#include <map>
 #include <mutex>
 #include <set>
 #include <utility>
@@ -122,10 +123,48 @@ public:
 private:
     enum class TriggerReason { added, reply, timeout };
 
+    // How fetching state nodes from one peer is going
+    struct PeerFetch
+    {
+        // Requests the peer has not answered yet
+        int outstanding = 0;
+
+        // Useful nodes per second, smoothed over recent replies
+        double rate = 0;
+
+        // When the peer last answered, or was sent a request while it
+        // had none outstanding
+        clock_type::time_point since;
+
+        // Whether the peer answered since the last timeout
+        bool replied = false;
+    };
+
     void
     filterNodes(
         std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-        TriggerReason reason);
+        TriggerReason reason,
+        int requests = 1);
+
+    /** Return the number of state node requests to send a peer.
+
+        A peer that answers is kept busy with several requests at once,
+        so that fetching is not bound by the round trip time.
+    */
+    int
+    stateRequests(std::shared_ptr<Peer> const& peer, TriggerReason reason);
+
+    /** Return the part of the state map to ask a peer for.
+
+        The branches of the root are split between the peers we are
+        fetching from, in proportion to how fast each has been answering,
+        so that peers are not asked for the same nodes.
+    */
+    SHAMap::RootBranches
+    stateBranches(Peer::id_t id) const;
+
+    void
+    onStateReply(Peer::id_t id, int useful);
 
     void
     trigger(std::shared_ptr<Peer> const&, TriggerReason);
@@ -157,8 +196,23 @@ private:
     bool
     takeHeader(std::string const& data);
 
+    /** Make the SHAMap nodes of a reply from their wire format.
+
+        Deserializing and hashing the nodes needs no lock, so it is done
+        before the nodes are added, spread over several threads when there
+        are many of them.
+
+        @return A node for each node in the packet, or nullptr for a root
+                node or a node that could not be made.
+    */
+    std::vector<std::shared_ptr<SHAMapTreeNode>>
+    makeNodes(protocol::TMLedgerData const& packet);
+
     void
-    receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode&);
+    receiveNode(
+        protocol::TMLedgerData& packet,
+        std::vector<std::shared_ptr<SHAMapTreeNode>> nodes,
+        SHAMapAddNode&);
 
     bool
     takeTxRootNode(Slice const& data, SHAMapAddNode&);
@@ -186,6 +240,8 @@ private:
 
     std::set<uint256> mRecentNodes;
 
+    std::map<Peer::id_t, PeerFetch> mPeerFetch;
+
     SHAMapAddNode mStats;
 
     // Data we have received from peers
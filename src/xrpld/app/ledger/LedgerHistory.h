@@ -132,6 +132,8 @@ private:
 
     // Maps ledger indexes to the corresponding hashes
     // For debug and logging purposes
+    // Entries are only read or changed under m_consensus_validated's
+    // peekMutex().
     struct cv_entry
     {
         // Hash of locally built ledger
@@ -149,6 +151,7 @@ private:
     ConsensusValidated m_consensus_validated;
 
     // Maps ledger indexes to the corresponding hash.
+    // Guarded by m_ledgers_by_hash's peekMutex().
     std::map<LedgerIndex, LedgerHash> mLedgersByIndex;  // validated ledgers
 
     beast::Journal j_;
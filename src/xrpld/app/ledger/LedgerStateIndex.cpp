@@ -0,0 +1,486 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/app/ledger/LedgerMaster.h>
+#include <xrpld/app/ledger/LedgerStateIndex.h>
+#include <xrpld/app/main/Application.h>
+#include <xrpld/core/JobQueue.h>
+#include <xrpl/basics/contract.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace {
+
+// The most ledgers that are brought in from the ledger history to close a
+// gap before the index is rebuilt instead.
+constexpr LedgerIndex maxGap = 256;
+
+// The most changed entries of a ledger that are stored as a delta.
+constexpr int maxDelta = 1'000'000;
+
+// Entries stored or read from the index at a time.
+constexpr std::size_t chunkSize = 4096;
+constexpr std::size_t pageSize = 256;
+
+std::shared_ptr<SLE const>
+makeSLE(uint256 const& key, Blob const& data)
+{
+    SerialIter sit(makeSlice(data));
+    return std::make_shared<SLE const>(sit, key);
+}
+
+/** A view of a ledger whose state is read from the state index.
+
+    Everything else comes from the ledger itself. If the index is rebuilt
+    while the view is in use, the view reads the ledger instead.
+*/
+class IndexedStateView : public ReadView
+{
+private:
+    class sles_iter_impl;
+
+    using Page = std::vector<std::shared_ptr<SLE const>>;
+
+    std::shared_ptr<ReadView const> const base_;
+    NodeStore::StateIndex& index_;
+    std::atomic<std::uint64_t> const& generation_;
+    std::uint64_t const expected_;
+
+    // Whether the index still holds the ledger. Reads from the index are
+    // only used if this is true after they complete.
+    bool
+    current() const
+    {
+        return generation_.load() == expected_;
+    }
+
+    // Return up to pageSize entries, starting with the first key that is
+    // not less than `from`.
+    Page
+    page(uint256 const& from) const;
+
+public:
+    IndexedStateView(
+        std::shared_ptr<ReadView const> base,
+        NodeStore::StateIndex& index,
+        std::atomic<std::uint64_t> const& generation,
+        std::uint64_t expected)
+        : base_(std::move(base))
+        , index_(index)
+        , generation_(generation)
+        , expected_(expected)
+    {
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_->info();
+    }
+
+    bool
+    open() const override
+    {
+        return false;
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_->fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_->rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        return read(k) != nullptr;
+    }
+
+    std::optional<key_type>
+    succ(key_type const& key, std::optional<key_type> const& last)
+        const override
+    {
+        auto next = key;
+        if (++next == beast::zero)
+            return std::nullopt;
+        if (!current())
+            return base_->succ(key, last);
+        auto const entries = index_.scan(seq(), next, 1);
+        if (!current())
+            return base_->succ(key, last);
+        if (entries.empty())
+            return std::nullopt;
+        if (last && entries.front().first >= *last)
+            return std::nullopt;
+        return entries.front().first;
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        if (k.key == beast::zero)
+        {
+            assert(false);
+            return nullptr;
+        }
+        if (!current())
+            return base_->read(k);
+        auto const data = index_.fetch(seq(), k.key);
+        if (!current())
+            return base_->read(k);
+        if (!data)
+            return nullptr;
+        auto sle = makeSLE(k.key, *data);
+        if (!k.check(*sle))
+            return nullptr;
+        return sle;
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override;
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override;
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override;
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        return base_->txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        return base_->txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        return base_->txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        return base_->txRead(key);
+    }
+};
+
+auto
+IndexedStateView::page(uint256 const& from) const -> Page
+{
+    Page result;
+    result.reserve(pageSize);
+
+    if (current())
+    {
+        auto const entries = index_.scan(seq(), from, pageSize);
+        if (current())
+        {
+            for (auto const& [key, data] : entries)
+                result.push_back(makeSLE(key, data));
+            return result;
+        }
+    }
+
+    auto it = base_->sles.begin();
+    if (from != beast::zero)
+    {
+        auto before = from;
+        it = base_->sles.upper_bound(--before);
+    }
+    for (; it != base_->sles.end() && result.size() < pageSize; ++it)
+        result.push_back(*it);
+    return result;
+}
+
+// Walks the state a page of entries at a time. Each page is parsed once,
+// when it is loaded.
+class IndexedStateView::sles_iter_impl : public sles_type::iter_base
+{
+private:
+    IndexedStateView const* view_;
+    std::shared_ptr<Page const> page_;
+    std::size_t pos_ = 0;
+
+    void
+    load(uint256 const& from)
+    {
+        page_ = std::make_shared<Page const>(view_->page(from));
+        pos_ = 0;
+    }
+
+public:
+    sles_iter_impl(sles_iter_impl const&) = default;
+
+    explicit sles_iter_impl(IndexedStateView const& view)
+        : view_(&view), page_(std::make_shared<Page const>())
+    {
+    }
+
+    sles_iter_impl(IndexedStateView const& view, uint256 const& from)
+        : view_(&view)
+    {
+        load(from);
+    }
+
+    std::unique_ptr<base_type>
+    copy() const override
+    {
+        return std::make_unique<sles_iter_impl>(*this);
+    }
+
+    bool
+    equal(base_type const& impl) const override
+    {
+        auto const p = dynamic_cast<sles_iter_impl const*>(&impl);
+        if (!p)
+            return false;
+        bool const end = pos_ == page_->size();
+        if (end || p->pos_ == p->page_->size())
+            return end && p->pos_ == p->page_->size();
+        return (*page_)[pos_]->key() == (*p->page_)[p->pos_]->key();
+    }
+
+    void
+    increment() override
+    {
+        assert(pos_ < page_->size());
+        if (++pos_ < page_->size() || page_->size() < pageSize)
+            return;
+
+        auto next = page_->back()->key();
+        if (++next == beast::zero)
+            return;
+        load(next);
+    }
+
+    sles_type::value_type
+    dereference() const override
+    {
+        return (*page_)[pos_];
+    }
+};
+
+auto
+IndexedStateView::slesBegin() const -> std::unique_ptr<sles_type::iter_base>
+{
+    return std::make_unique<sles_iter_impl>(*this, uint256{});
+}
+
+auto
+IndexedStateView::slesEnd() const -> std::unique_ptr<sles_type::iter_base>
+{
+    return std::make_unique<sles_iter_impl>(*this);
+}
+
+auto
+IndexedStateView::slesUpperBound(uint256 const& key) const
+    -> std::unique_ptr<sles_type::iter_base>
+{
+    auto next = key;
+    if (++next == beast::zero)
+        return slesEnd();
+    return std::make_unique<sles_iter_impl>(*this, next);
+}
+
+}  // namespace
+
+LedgerStateIndex::LedgerStateIndex(
+    Application& app,
+    std::unique_ptr<NodeStore::StateIndex> index,
+    beast::Journal journal)
+    : app_(app), index_(std::move(index)), j_(journal)
+{
+}
+
+void
+LedgerStateIndex::onLedger(std::shared_ptr<Ledger const> const& ledger)
+{
+    {
+        std::lock_guard sl(mutex_);
+        next_ = ledger;
+        if (working_)
+            return;
+        working_ = true;
+    }
+
+    // Only the newest waiting ledger is kept, and update() fills in any
+    // ledgers that were skipped.
+    bool const added =
+        app_.getJobQueue().addJob(jtWRITE, "LedgerStateIndex", [this]() {
+            for (;;)
+            {
+                std::shared_ptr<Ledger const> ledger;
+                {
+                    std::lock_guard sl(mutex_);
+                    ledger = std::move(next_);
+                    next_.reset();
+                    if (!ledger)
+                    {
+                        working_ = false;
+                        return;
+                    }
+                }
+
+                try
+                {
+                    update(ledger);
+                }
+                catch (std::exception const& e)
+                {
+                    JLOG(j_.error()) << "Unable to index ledger "
+                                     << ledger->info().seq << ": " << e.what();
+                }
+            }
+        });
+
+    if (!added)
+    {
+        std::lock_guard sl(mutex_);
+        working_ = false;
+    }
+}
+
+void
+LedgerStateIndex::update(std::shared_ptr<Ledger const> const& ledger)
+{
+    auto const seq = ledger->info().seq;
+    auto const range = index_->range();
+    if (range && seq >= range->first && seq <= range->second)
+        return;
+
+    if (range && seq > range->second && seq - range->second <= maxGap)
+    {
+        auto& ledgerMaster = app_.getLedgerMaster();
+        auto parent = ledgerMaster.getLedgerBySeq(range->second);
+        for (auto s = range->second + 1; parent; ++s)
+        {
+            auto const child =
+                s == seq ? ledger : ledgerMaster.getLedgerBySeq(s);
+            if (!child || child->info().parentHash != parent->info().hash ||
+                !applyDelta(*child, *parent))
+                break;
+            if (s == seq)
+                return;
+            parent = child;
+        }
+        JLOG(j_.info()) << "Unable to bring the state index from ledger "
+                        << range->second << " to " << seq;
+    }
+
+    rebuild(*ledger);
+}
+
+std::shared_ptr<ReadView const>
+LedgerStateIndex::view(std::shared_ptr<ReadView const> const& ledger) const
+{
+    if (!ledger || ledger->open() || !ledger->info().validated)
+        return ledger;
+
+    // Read the generation first, so a rebuild that starts after the range
+    // is checked is noticed by the view
+    auto const generation = generation_.load();
+    auto const range = index_->range();
+    if (!range || ledger->seq() < range->first || ledger->seq() > range->second)
+        return ledger;
+
+    return std::make_shared<IndexedStateView>(
+        ledger, *index_, generation_, generation);
+}
+
+void
+LedgerStateIndex::prune(LedgerIndex seq)
+{
+    auto const range = index_->range();
+    if (!range || seq <= range->first)
+        return;
+
+    // Views of the old range stop reading from the index before any of it
+    // is deleted
+    ++generation_;
+    index_->prune(seq);
+    JLOG(j_.info()) << "State index pruned to start at ledger "
+                    << std::min(seq, range->second);
+}
+
+void
+LedgerStateIndex::rebuild(Ledger const& ledger)
+{
+    auto const seq = ledger.info().seq;
+    JLOG(j_.info()) << "Rebuilding the state index from ledger " << seq;
+
+    // Views of the old range stop reading from the index before it is
+    // cleared
+    ++generation_;
+    index_->clear();
+    std::vector<NodeStore::StateIndex::Entry> entries;
+    entries.reserve(chunkSize);
+    for (auto const& item : ledger.stateMap())
+    {
+        auto const data = item.slice();
+        entries.emplace_back(item.key(), Blob(data.begin(), data.end()));
+        if (entries.size() == chunkSize)
+        {
+            if (app_.getJobQueue().isStopping())
+                return;
+            index_->store(seq, entries);
+            entries.clear();
+        }
+    }
+    index_->store(seq, entries);
+    index_->commit(seq, true);
+
+    JLOG(j_.info()) << "State index rebuilt from ledger " << seq;
+}
+
+bool
+LedgerStateIndex::applyDelta(Ledger const& ledger, Ledger const& parent)
+{
+    SHAMap::Delta delta;
+    if (!ledger.stateMap().compare(parent.stateMap(), delta, maxDelta))
+        return false;
+
+    std::vector<NodeStore::StateIndex::Entry> entries;
+    entries.reserve(delta.size());
+    for (auto const& [key, items] : delta)
+    {
+        // A deletion is stored without data
+        Blob data;
+        if (auto const& item = items.first)
+            data.assign(item->slice().begin(), item->slice().end());
+        entries.emplace_back(key, std::move(data));
+    }
+    index_->store(ledger.info().seq, entries);
+    index_->commit(ledger.info().seq, false);
+    return true;
+}
+
+}  // namespace ripple
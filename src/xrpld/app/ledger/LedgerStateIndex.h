@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERSTATEINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERSTATEINDEX_H_INCLUDED
+
+#include <xrpld/app/ledger/Ledger.h>
+#include <xrpld/nodestore/StateIndex.h>
+#include <xrpl/beast/utility/Journal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+class Application;
+
+/** Keeps a flat index of the state of recent validated ledgers.
+
+    Servers that answer many ledger_data, ledger_entry and account_objects
+    requests can enable the index with `state_index=1` in `[node_db]`. Each
+    published ledger is then added to a StateIndex held by the node store
+    backend, and views of indexed ledgers read their state from it instead
+    of walking the SHAMap.
+*/
+class LedgerStateIndex
+{
+public:
+    LedgerStateIndex(
+        Application& app,
+        std::unique_ptr<NodeStore::StateIndex> index,
+        beast::Journal journal);
+
+    /** Add a published ledger to the index in the background. */
+    void
+    onLedger(std::shared_ptr<Ledger const> const& ledger);
+
+    /** Add a ledger to the index.
+
+        If the ledger does not follow the last indexed one, the ledgers in
+        between are indexed from the ledger history if they are available.
+        Otherwise the index is rebuilt from this ledger.
+    */
+    void
+    update(std::shared_ptr<Ledger const> const& ledger);
+
+    /** Return a view of a ledger that reads its state from the index.
+
+        Only validated ledgers that are in the indexed range are served from
+        the index; anything else is returned unchanged. If the index is
+        rebuilt while the view is in use, the view reads the ledger's own
+        state instead.
+    */
+    std::shared_ptr<ReadView const>
+    view(std::shared_ptr<ReadView const> const& ledger) const;
+
+    /** Drop the state of ledgers before `seq` from the index.
+
+        Called when online_delete removes those ledgers. Views made before
+        the index is pruned read their ledger's own state instead.
+    */
+    void
+    prune(LedgerIndex seq);
+
+private:
+    void
+    rebuild(Ledger const& ledger);
+
+    bool
+    applyDelta(Ledger const& ledger, Ledger const& parent);
+
+    Application& app_;
+    std::unique_ptr<NodeStore::StateIndex> const index_;
+    beast::Journal const j_;
+
+    // Changes whenever the index is rebuilt or pruned, so views of the
+    // ledgers it held can tell that it may no longer hold them
+    std::atomic<std::uint64_t> generation_{0};
+
+    std::mutex mutex_;
+    // The newest ledger waiting to be indexed
+    std::shared_ptr<Ledger const> next_;
+    bool working_ = false;
+};
+
+}  // namespace ripple
+
+#endif
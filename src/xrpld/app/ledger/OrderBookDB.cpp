@@ -29,6 +29,9 @@
 
 namespace ripple {
 
+// The most ledgers whose changes are held while a full update runs
+static constexpr std::size_t maxPendingLedgers = 256;
+
 OrderBookDB::OrderBookDB(Application& app)
     : app_(app), seq_(0), j_(app.journal("OrderBookDB"))
 {
@@ -43,19 +46,25 @@ OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
-    auto seq = seq_.load();
+    std::uint32_t seq;
 
-    if (seq != 0)
     {
-        if ((ledger->seq() > seq) && ((ledger->seq() - seq) < 25600))
-            return;
+        std::lock_guard sl(mLock);
 
-        if ((ledger->seq() <= seq) && ((seq - ledger->seq()) < 16))
+        // Once built, the index is kept current one ledger at a time, so a
+        // full update is only needed to bootstrap it or to cover a gap.
+        if (nextSeq_ != 0 && ledger->seq() <= nextSeq_ &&
+            (nextSeq_ - ledger->seq()) < 16)
             return;
-    }
 
-    if (seq_.exchange(ledger->seq()) != seq)
-        return;
+        seq = seq_.exchange(ledger->seq());
+        nextSeq_ = ledger->seq() + 1;
+        pending_.clear();
+
+        // The index no longer reflects a ledger that changes can be applied
+        // to, so queue them until the full update is done
+        indexSeq_ = 0;
+    }
 
     JLOG(j_.debug()) << "Full order book update: " << seq << " to "
                      << ledger->seq();
@@ -86,6 +95,17 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
         return;
     }
 
+    // Give up on this update; the next accepted ledger starts another
+    auto const abandon = [this, seq = ledger->seq()]() {
+        std::lock_guard sl(mLock);
+        if (seq_.load() == seq)
+        {
+            seq_.store(0);
+            nextSeq_ = 0;
+            pending_.clear();
+        }
+    };
+
     decltype(allBooks_) allBooks;
     decltype(xrpBooks_) xrpBooks;
 
@@ -105,7 +125,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
             {
                 JLOG(j_.info())
                     << "Update halted because the process is stopping";
-                seq_.store(0);
+                abandon();
                 return;
             }
 
@@ -148,7 +168,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         JLOG(j_.info()) << "Missing node in " << ledger->seq()
                         << " during update: " << mn.what();
-        seq_.store(0);
+        abandon();
         return;
     }
 
@@ -157,13 +177,208 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
 
     {
         std::lock_guard sl(mLock);
+
+        if (auto const seq = seq_.load(); seq != ledger->seq())
+        {
+            JLOG(j_.debug()) << "Discarding update for " << ledger->seq()
+                             << " because of later update to " << seq;
+            return;
+        }
+
+        // Another full update for this ledger already landed, and may have
+        // applied later ledgers since
+        if (indexSeq_ != 0)
+        {
+            JLOG(j_.debug()) << "Discarding repeated update for "
+                             << ledger->seq();
+            return;
+        }
+
         allBooks_.swap(allBooks);
         xrpBooks_.swap(xrpBooks);
+        indexSeq_ = ledger->seq();
+
+        // Catch up with the ledgers accepted while the update ran
+        for (auto const& [seq, changes] : pending_)
+        {
+            assert(seq == indexSeq_ + 1);
+            applyChanges(changes);
+            indexSeq_ = seq;
+        }
+        pending_.clear();
     }
 
     app_.getLedgerMaster().newOrderBookDB();
 }
 
+void
+OrderBookDB::update(AcceptedLedger const& accepted)
+{
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;  // pathfinding has been disabled
+
+    auto const& ledger = accepted.getLedger();
+    auto const seq = ledger->seq();
+
+    bool follows;
+
+    {
+        std::lock_guard sl(mLock);
+
+        // Already covered by a full update
+        if (nextSeq_ != 0 && seq < nextSeq_)
+            return;
+
+        follows = (seq == nextSeq_);
+    }
+
+    if (!follows)
+    {
+        JLOG(j_.debug()) << "Ledger " << seq << " does not follow the index";
+        setup(ledger);
+        return;
+    }
+
+    BookChanges changes;
+
+    try
+    {
+        changes = getChanges(accepted);
+    }
+    catch (SHAMapMissingNode const& mn)
+    {
+        JLOG(j_.info()) << "Missing node in " << seq
+                        << " during incremental update: " << mn.what();
+        std::lock_guard sl(mLock);
+        nextSeq_ = 0;
+        return;
+    }
+
+    {
+        std::lock_guard sl(mLock);
+
+        if (nextSeq_ != 0 && seq < nextSeq_)
+            return;
+
+        if (seq == nextSeq_)
+        {
+            if (indexSeq_ + 1 == seq)
+            {
+                applyChanges(changes);
+                indexSeq_ = nextSeq_++;
+                return;
+            }
+
+            // A full update is running; apply these changes once it is done
+            if (pending_.size() < maxPendingLedgers)
+            {
+                pending_.emplace(seq, std::move(changes));
+                ++nextSeq_;
+                return;
+            }
+
+            JLOG(j_.warn()) << "Too many ledgers accepted during update";
+        }
+
+        nextSeq_ = 0;
+    }
+
+    setup(ledger);
+}
+
+OrderBookDB::BookChanges
+OrderBookDB::getChanges(AcceptedLedger const& accepted) const
+{
+    hash_set<Book> touched;
+
+    for (auto const& alTx : accepted)
+    {
+        for (auto const& node : alTx->getMeta().getNodes())
+        {
+            // Books only appear or disappear when a book directory or an AMM
+            // instance is created or deleted.
+            SField const* field = nullptr;
+            if (node.getFName() == sfCreatedNode)
+                field = &sfNewFields;
+            else if (node.getFName() == sfDeletedNode)
+                field = &sfFinalFields;
+            else
+                continue;
+
+            auto const data =
+                dynamic_cast<STObject const*>(node.peekAtPField(*field));
+            if (!data)
+                continue;
+
+            auto const type = node.getFieldU16(sfLedgerEntryType);
+            if (type == ltDIR_NODE && data->isFieldPresent(sfExchangeRate))
+            {
+                // Fields holding XRP are defaulted and may be omitted
+                auto const h160 = [&data](SField const& f) {
+                    return data->isFieldPresent(f) ? data->getFieldH160(f)
+                                                   : uint160{};
+                };
+
+                Book book;
+                book.in.currency = h160(sfTakerPaysCurrency);
+                book.in.account = h160(sfTakerPaysIssuer);
+                book.out.currency = h160(sfTakerGetsCurrency);
+                book.out.account = h160(sfTakerGetsIssuer);
+                touched.insert(book);
+            }
+            else if (type == ltAMM)
+            {
+                auto const issue1 = (*data)[~sfAsset].value_or(xrpIssue());
+                auto const issue2 = (*data)[~sfAsset2].value_or(xrpIssue());
+                touched.insert(Book(issue1, issue2));
+                touched.insert(Book(issue2, issue1));
+            }
+        }
+    }
+
+    // A book survives as long as it has a directory or an AMM instance
+    auto const& view = *accepted.getLedger();
+    BookChanges changes;
+    changes.reserve(touched.size());
+    for (auto const& book : touched)
+    {
+        auto const base = getBookBase(book);
+        changes.emplace_back(
+            book,
+            view.succ(base, getQualityNext(base)).has_value() ||
+                view.exists(keylet::amm(book.in, book.out)));
+    }
+
+    return changes;
+}
+
+void
+OrderBookDB::applyChanges(BookChanges const& changes)
+{
+    for (auto const& [book, exists] : changes)
+    {
+        if (exists)
+        {
+            allBooks_[book.in].insert(book.out);
+
+            if (isXRP(book.out))
+                xrpBooks_.insert(book.in);
+        }
+        else
+        {
+            if (auto it = allBooks_.find(book.in); it != allBooks_.end())
+            {
+                it->second.erase(book.out);
+                if (it->second.empty())
+                    allBooks_.erase(it);
+            }
+
+            if (isXRP(book.out))
+                xrpBooks_.erase(book.in);
+        }
+    }
+}
+
 void
 OrderBookDB::addOrderBook(Book const& book)
 {
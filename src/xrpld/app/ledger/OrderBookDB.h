@@ -20,12 +20,15 @@
 #ifndef RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 #define RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 
+#include <xrpld/app/ledger/AcceptedLedger.h>
 #include <xrpld/app/ledger/AcceptedLedgerTx.h>
 #include <xrpld/app/ledger/BookListeners.h>
 #include <xrpld/app/main/Application.h>
 #include <xrpl/protocol/MultiApiJson.h>
 
+#include <map>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -39,6 +42,16 @@ public:
     void
     update(std::shared_ptr<ReadView const> const& ledger);
 
+    /** Bring the order book index forward by one accepted ledger.
+
+        Books whose directories or AMM instances were created or deleted by
+        the ledger's transactions are added or removed. If the ledger does
+        not immediately follow the last one applied, a full update is
+        started instead.
+    */
+    void
+    update(AcceptedLedger const& accepted);
+
     void
     addOrderBook(Book const&);
 
@@ -68,6 +81,15 @@ public:
         MultiApiJson const& jvObj);
 
 private:
+    // Books touched by a ledger, and whether each one still exists in it
+    using BookChanges = std::vector<std::pair<Book, bool>>;
+
+    BookChanges
+    getChanges(AcceptedLedger const& accepted) const;
+
+    void
+    applyChanges(BookChanges const& changes);
+
     Application& app_;
 
     // Maps order books by "issue in" to "issue out":
@@ -84,6 +106,17 @@ private:
 
     std::atomic<std::uint32_t> seq_;
 
+    // The ledger whose changes are needed next to keep the index current,
+    // or zero if a full update is required.
+    std::uint32_t nextSeq_ = 0;
+
+    // The ledger the index currently reflects, or zero while a full update
+    // is pending
+    std::uint32_t indexSeq_ = 0;
+
+    // Changes from ledgers accepted while a full update is running
+    std::map<std::uint32_t, BookChanges> pending_;
+
     beast::Journal const j_;
 };
 
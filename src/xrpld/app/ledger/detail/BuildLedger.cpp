@@ -24,7 +24,14 @@
 #include <xrpld/app/main/Application.h>
 #include <xrpld/app/misc/CanonicalTXSet.h>
 #include <xrpld/app/tx/apply.h>
+#include <xrpld/core/Config.h>
+#include <xrpld/core/JobQueue.h>
 #include <xrpl/protocol/Feature.h>
+#include <xrpl/protocol/STTx.h>
+
+#include <optional>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -83,64 +90,361 @@ buildLedgerImpl(
     return built;
 }
 
-/** Apply a set of consensus transactions to a ledger.
+namespace {
 
-  @param app Handle to application
-  @param txns the set of transactions to apply,
-  @param failed set of transactions that failed to apply
-  @param view ledger to apply to
-  @param j Journal for logging
-  @return number of transactions applied; transactions to retry left in txns
+/** A view that records the state a transaction reads.
+
+    Transactions are applied speculatively on top of this view, and the
+    keys they read are later compared with the keys written by the
+    transactions ahead of them in canonical order.
 */
+class ReadSetView : public ReadView
+{
+private:
+    ReadView const& base_;
 
-std::size_t
-applyTransactions(
+    // Keys read, and the ranges searched by succ, as (from, to]
+    std::vector<key_type> mutable keys_;
+    std::vector<std::pair<key_type, std::optional<key_type>>> mutable ranges_;
+
+    // Set if the caller iterated the state or transactions
+    bool mutable all_ = false;
+
+public:
+    explicit ReadSetView(ReadView const& base) : base_(base)
+    {
+    }
+
+    /** Returns `true` if any of the reads could see one of the writes. */
+    bool
+    conflicts(std::set<key_type> const& written) const
+    {
+        if (written.empty())
+            return false;
+
+        if (all_)
+            return true;
+
+        for (auto const& key : keys_)
+        {
+            if (written.count(key))
+                return true;
+        }
+
+        for (auto const& [from, to] : ranges_)
+        {
+            auto const it = written.upper_bound(from);
+            if (it != written.end() && (!to || *it <= *to))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.exists(k);
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        keys_.push_back(k.key);
+        return base_.read(k);
+    }
+
+    std::optional<key_type>
+    succ(
+        key_type const& key,
+        std::optional<key_type> const& last = std::nullopt) const override
+    {
+        auto next = base_.succ(key, last);
+        ranges_.emplace_back(key, next ? next : last);
+        return next;
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    STAmount
+    balanceHook(
+        AccountID const& account,
+        AccountID const& issuer,
+        STAmount const& amount) const override
+    {
+        return base_.balanceHook(account, issuer, amount);
+    }
+
+    std::uint32_t
+    ownerCountHook(AccountID const& account, std::uint32_t count)
+        const override
+    {
+        return base_.ownerCountHook(account, count);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        all_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        all_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        all_ = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        all_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        all_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        keys_.push_back(key);
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        keys_.push_back(key);
+        return base_.txRead(key);
+    }
+};
+
+/** Commits the changes made by one transaction to the ledger being built.
+
+    The keys written are recorded. The transaction was applied to a view of
+    its own, so the index in its metadata is set to its position in the
+    ledger.
+*/
+class CommitView : public TxsRawView
+{
+private:
+    OpenView& to_;
+    std::set<uint256>& written_;
+
+public:
+    CommitView(OpenView& to, std::set<uint256>& written)
+        : to_(to), written_(written)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawErase(sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawInsert(sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert(sle->key());
+        to_.rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        to_.rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        written_.insert(key);
+
+        if (!metaData)
+            return to_.rawTxInsert(key, txn, metaData);
+
+        STObject meta(SerialIter{metaData->slice()}, sfMetadata);
+        meta.setFieldU32(sfTransactionIndex, to_.txCount());
+
+        auto s = std::make_shared<Serializer>();
+        meta.add(*s);
+        to_.rawTxInsert(key, txn, s);
+    }
+};
+
+// Transactions applied speculatively between commits
+constexpr std::size_t speculativeBatch = 256;
+
+struct Speculation
+{
+    std::optional<ReadSetView> reads;
+    std::optional<OpenView> view;
+    std::optional<ApplyResult> result;
+};
+
+/** Apply one pass over a set of consensus transactions, in parallel.
+
+  The transactions are taken in batches. Each transaction in a batch is
+  first applied to a view of its own, on top of the ledger as it stood
+  before the batch. They are then committed in canonical order; one that
+  read state written by a transaction committed ahead of it in the batch
+  is applied again, so the ledger is the same as if they were applied one
+  at a time.
+
+  @return number of transactions applied; transactions to retry left in txns
+*/
+int
+applySpeculatively(
     Application& app,
     std::shared_ptr<Ledger const> const& built,
     CanonicalTXSet& txns,
     std::set<TxID>& failed,
     OpenView& view,
+    int pass,
+    bool certainRetry,
+    std::size_t workers,
     beast::Journal j)
 {
-    bool certainRetry = true;
-    std::size_t count = 0;
+    int changes = 0;
+    std::size_t reapplied = 0;
 
-    // Attempt to apply all of the retriable transactions
-    for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
+    std::vector<CanonicalTXSet::const_iterator> batch;
+    batch.reserve(speculativeBatch);
+
+    auto it = txns.begin();
+
+    while (it != txns.end())
     {
-        JLOG(j.debug()) << (certainRetry ? "Pass: " : "Final pass: ") << pass
-                        << " begins (" << txns.size() << " transactions)";
-        int changes = 0;
+        batch.clear();
+        for (; it != txns.end() && batch.size() < speculativeBatch; ++it)
+            batch.push_back(it);
+
+        std::vector<Speculation> specs(batch.size());
+
+        app.getJobQueue().parallelFor(
+            jtACCEPT,
+            "applyTransactions",
+            batch.size(),
+            workers,
+            [&](std::size_t i) {
+                auto const& tx = *batch[i]->second;
+
+                // Pseudo-transactions can change more than the ledger,
+                // so they are only applied once, when committed.
+                if (isPseudoTx(tx))
+                    return;
+
+                auto& spec = specs[i];
+                try
+                {
+                    if (pass == 0 && built->txExists(tx.getTransactionID()))
+                        return;
 
-        auto it = txns.begin();
+                    spec.reads.emplace(view);
+                    spec.view.emplace(&*spec.reads);
+                    spec.result = applyTransaction(
+                        app, *spec.view, tx, certainRetry, tapNONE, j);
+                }
+                catch (std::exception const&)
+                {
+                    // Applied again, and reported, when committed.
+                    spec.result.reset();
+                }
+            });
 
-        while (it != txns.end())
+        std::set<uint256> written;
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
         {
-            auto const txid = it->first.getTXID();
+            auto const txid = batch[i]->first.getTXID();
+            auto& spec = specs[i];
 
             try
             {
                 if (pass == 0 && built->txExists(txid))
                 {
-                    it = txns.erase(it);
+                    txns.erase(batch[i]);
                     continue;
                 }
 
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
+                if (!spec.result || spec.reads->conflicts(written))
                 {
-                    case ApplyResult::Success:
-                        it = txns.erase(it);
+                    ++reapplied;
+                    spec.view.emplace(&view);
+                    spec.result = applyTransaction(
+                        app,
+                        *spec.view,
+                        *batch[i]->second,
+                        certainRetry,
+                        tapNONE,
+                        j);
+                }
+
+                switch (*spec.result)
+                {
+                    case ApplyResult::Success: {
+                        CommitView to(view, written);
+                        spec.view->apply(to);
+                        txns.erase(batch[i]);
                         ++changes;
                         break;
+                    }
 
                     case ApplyResult::Fail:
                         failed.insert(txid);
-                        it = txns.erase(it);
+                        txns.erase(batch[i]);
                         break;
 
                     case ApplyResult::Retry:
-                        ++it;
+                        break;
                 }
             }
             catch (std::exception const& ex)
@@ -148,7 +452,95 @@ applyTransactions(
                 JLOG(j.warn())
                     << "Transaction " << txid << " throws: " << ex.what();
                 failed.insert(txid);
-                it = txns.erase(it);
+                txns.erase(batch[i]);
+            }
+        }
+    }
+
+    JLOG(j.debug()) << "Pass: " << pass << " applied " << reapplied
+                    << " transactions again after speculating";
+
+    return changes;
+}
+
+}  // namespace
+
+/** Apply a set of consensus transactions to a ledger.
+
+  @param app Handle to application
+  @param txns the set of transactions to apply,
+  @param failed set of transactions that failed to apply
+  @param view ledger to apply to
+  @param j Journal for logging
+  @return number of transactions applied; transactions to retry left in txns
+*/
+
+std::size_t
+applyTransactions(
+    Application& app,
+    std::shared_ptr<Ledger const> const& built,
+    CanonicalTXSet& txns,
+    std::set<TxID>& failed,
+    OpenView& view,
+    beast::Journal j)
+{
+    auto const workers = static_cast<std::size_t>(
+        std::max(app.config().LEDGER_BUILD_WORKERS, 1));
+    bool certainRetry = true;
+    std::size_t count = 0;
+
+    // Attempt to apply all of the retriable transactions
+    for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
+    {
+        JLOG(j.debug()) << (certainRetry ? "Pass: " : "Final pass: ") << pass
+                        << " begins (" << txns.size() << " transactions)";
+        int changes = 0;
+
+        if (workers > 1)
+        {
+            changes = applySpeculatively(
+                app, built, txns, failed, view, pass, certainRetry, workers, j);
+        }
+        else
+        {
+            auto it = txns.begin();
+
+            while (it != txns.end())
+            {
+                auto const txid = it->first.getTXID();
+
+                try
+                {
+                    if (pass == 0 && built->txExists(txid))
+                    {
+                        it = txns.erase(it);
+                        continue;
+                    }
+
+                    switch (applyTransaction(
+                        app, view, *it->second, certainRetry, tapNONE, j))
+                    {
+                        case ApplyResult::Success:
+                            it = txns.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            failed.insert(txid);
+                            it = txns.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const& ex)
+                {
+                    JLOG(j.warn())
+                        << "Transaction " << txid << " throws: " << ex.what();
+                    failed.insert(txid);
+                    it = txns.erase(it);
+                }
             }
         }
 
@@ -69,6 +69,14 @@ enum {
     // Number of nodes to request blindly
     ,
     reqNodes = 12
+
+    // Number of nodes in a reply above which they are made in parallel
+    ,
+    parallelNodesMin = 256
+
+    // Number of state node requests to keep outstanding with a peer
+    ,
+    reqPipelineDepth = 3
 };
 
 // millisecond for each ledger timeout
@@ -403,6 +411,18 @@ InboundLedger::onTimer(bool wasProgress, ScopedLockType&)
 {
     mRecentNodes.clear();
 
+    // The nodes asked of peers that have stopped answering will be asked
+    // of others, and those peers get a smaller part of the map
+    for (auto& [id, fetch] : mPeerFetch)
+    {
+        if (fetch.outstanding != 0 && !fetch.replied)
+        {
+            fetch.outstanding = 0;
+            fetch.rate /= 2;
+        }
+        fetch.replied = false;
+    }
+
     if (isDone())
     {
         JLOG(journal_.info()) << "Already done " << hash_;
@@ -677,10 +697,28 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
             AccountStateSF filter(
                 mLedger->stateMap().family().db(), app_.getLedgerMaster());
 
+            int const requests = stateRequests(peer, reason);
+            if (requests == 0)
+            {
+                JLOG(journal_.trace()) << "Peer has enough AS requests";
+                return;
+            }
+
+            auto const branches = (peer && reason == TriggerReason::reply)
+                ? stateBranches(peer->id())
+                : SHAMap::RootBranches().set();
+            int const find = missingNodesFind + (requests - 1) * reqNodesReply;
+
             // Release the lock while we process the large state map
             sl.unlock();
             auto nodes =
-                mLedger->stateMap().getMissingNodes(missingNodesFind, &filter);
+                mLedger->stateMap().getMissingNodes(find, &filter, branches);
+            if (nodes.empty() && !branches.all())
+            {
+                // This peer's part of the map is done, so it can help
+                // with the rest
+                nodes = mLedger->stateMap().getMissingNodes(find, &filter);
+            }
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -700,21 +738,37 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                 }
                 else
                 {
-                    filterNodes(nodes, reason);
+                    filterNodes(nodes, reason, requests);
 
                     if (!nodes.empty())
                     {
                         tmGL.set_itype(protocol::liAS_NODE);
-                        for (auto const& id : nodes)
+                        for (std::size_t i = 0; i < nodes.size();
+                             i += reqNodesReply)
                         {
-                            *(tmGL.add_nodeids()) = id.first.getRawString();
+                            auto const end = std::min<std::size_t>(
+                                i + reqNodesReply, nodes.size());
+
+                            tmGL.clear_nodeids();
+                            for (auto j = i; j != end; ++j)
+                            {
+                                *(tmGL.add_nodeids()) =
+                                    nodes[j].first.getRawString();
+                            }
+
+                            JLOG(journal_.trace())
+                                << "Sending AS node request (" << end - i
+                                << ") to "
+                                << (peer ? "selected peer" : "all peers");
+                            mPeerSet->sendRequest(tmGL, peer);
+
+                            if (peer)
+                            {
+                                auto& fetch = mPeerFetch[peer->id()];
+                                if (fetch.outstanding++ == 0)
+                                    fetch.since = m_clock.now();
+                            }
                         }
-
-                        JLOG(journal_.trace())
-                            << "Sending AS node request (" << nodes.size()
-                            << ") to "
-                            << (peer ? "selected peer" : "all peers");
-                        mPeerSet->sendRequest(tmGL, peer);
                         return;
                     }
                     else
@@ -802,7 +856,8 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
 void
 InboundLedger::filterNodes(
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-    TriggerReason reason)
+    TriggerReason reason,
+    int requests)
 {
     // Sort nodes so that the ones we haven't recently
     // requested come before the ones we have.
@@ -832,7 +887,8 @@ InboundLedger::filterNodes(
     }
 
     std::size_t const limit =
-        (reason == TriggerReason::reply) ? reqNodesReply : reqNodes;
+        ((reason == TriggerReason::reply) ? reqNodesReply : reqNodes) *
+        requests;
 
     if (nodes.size() > limit)
         nodes.resize(limit);
@@ -841,6 +897,93 @@ InboundLedger::filterNodes(
         mRecentNodes.insert(n.second);
 }
 
+int
+InboundLedger::stateRequests(
+    std::shared_ptr<Peer> const& peer,
+    TriggerReason reason)
+{
+    if (!peer || reason != TriggerReason::reply)
+        return 1;
+
+    auto const& fetch = mPeerFetch[peer->id()];
+    return std::max(reqPipelineDepth - fetch.outstanding, 0);
+}
+
+SHAMap::RootBranches
+InboundLedger::stateBranches(Peer::id_t id) const
+{
+    auto const& peerIds = mPeerSet->getPeerIds();
+
+    // Peers we have not measured yet count as average ones
+    double measured = 0;
+    int count = 0;
+    for (auto const& [peerId, fetch] : mPeerFetch)
+    {
+        if (fetch.rate > 0 && peerIds.count(peerId) != 0)
+        {
+            measured += fetch.rate;
+            ++count;
+        }
+    }
+    double const average = count != 0 ? measured / count : 1;
+
+    std::vector<std::pair<Peer::id_t, double>> rates;
+    double total = 0;
+    for (auto const& [peerId, fetch] : mPeerFetch)
+    {
+        if (peerIds.count(peerId) != 0 || peerId == id)
+        {
+            auto const rate = fetch.rate > 0 ? fetch.rate : average;
+            rates.emplace_back(peerId, rate);
+            total += rate;
+        }
+    }
+
+    // Each peer gets a contiguous run of branches, and at least one
+    double before = 0;
+    for (auto const& [peerId, rate] : rates)
+    {
+        if (peerId == id)
+        {
+            auto const n = SHAMap::branchFactor;
+            auto const first = std::min<std::size_t>(
+                static_cast<std::size_t>(n * before / total), n - 1);
+            auto const last = std::max<std::size_t>(
+                static_cast<std::size_t>(n * (before + rate) / total),
+                first + 1);
+
+            SHAMap::RootBranches ret;
+            for (auto b = first; b != last && b != n; ++b)
+                ret.set(b);
+            return ret;
+        }
+        before += rate;
+    }
+
+    return SHAMap::RootBranches().set();
+}
+
+void
+InboundLedger::onStateReply(Peer::id_t id, int useful)
+{
+    auto& fetch = mPeerFetch[id];
+    auto const now = m_clock.now();
+
+    if (fetch.outstanding != 0)
+    {
+        using namespace std::chrono;
+        --fetch.outstanding;
+
+        auto const elapsed =
+            std::max(duration_cast<milliseconds>(now - fetch.since), 1ms);
+        double const rate = std::max(useful, 0) * 1000.0 / elapsed.count();
+        fetch.rate = fetch.rate > 0 ? (fetch.rate * 3 + rate) / 4 : rate;
+    }
+
+    fetch.since = now;
+    fetch.replied = true;
+}
+
 /** Take ledger header data
     Call with a lock
 */
@@ -890,11 +1033,53 @@ InboundLedger::takeHeader(std::string const& data)
     return true;
 }
 
+std::vector<std::shared_ptr<SHAMapTreeNode>>
+InboundLedger::makeNodes(protocol::TMLedgerData const& packet)
+{
+    std::vector<std::shared_ptr<SHAMapTreeNode>> nodes(packet.nodes_size());
+
+    auto make = [&packet, &nodes](std::size_t i) {
+        auto const& node = packet.nodes(i);
+        // A root node is added from its wire format
+        if (auto const id = deserializeSHAMapNodeID(node.nodeid());
+            !id || id->isRoot())
+            return;
+        try
+        {
+            nodes[i] = SHAMapTreeNode::makeFromWire(makeSlice(node.nodedata()));
+        }
+        catch (std::exception const&)
+        {
+            // Leave it empty; adding the node reports it as invalid
+        }
+    };
+
+    if (nodes.size() < parallelNodesMin)
+    {
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            make(i);
+    }
+    else
+    {
+        app_.getJobQueue().parallelFor(
+            jtLEDGER_DATA,
+            "InboundLedger::makeNodes",
+            nodes.size(),
+            JobQueue::defaultWorkers(),
+            make);
+    }
+
+    return nodes;
+}
+
 /** Process node data received from a peer
     Call with a lock
 */
 void
-InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
+InboundLedger::receiveNode(
+    protocol::TMLedgerData& packet,
+    std::vector<std::shared_ptr<SHAMapTreeNode>> nodes,
+    SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -935,8 +1120,9 @@ InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
     {
         auto const f = filter.get();
 
-        for (auto const& node : packet.nodes())
+        for (int i = 0; i < packet.nodes_size(); ++i)
         {
+            auto const& node = packet.nodes(i);
             auto const nodeID = deserializeSHAMapNodeID(node.nodeid());
 
             if (!nodeID)
@@ -948,7 +1134,7 @@ InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
             }
             else
             {
-                san += map.addKnownNode(*nodeID, makeSlice(node.nodedata()), f);
+                san += map.addKnownNode(*nodeID, std::move(nodes[i]), f);
             }
 
             if (!san.isGood())
@@ -1169,8 +1355,6 @@ InboundLedger::processData(
             return -1;
         }
 
-        ScopedLockType sl(mtx_);
-
         // Verify node IDs and data are complete
         for (auto const& node : packet.nodes())
         {
@@ -1182,8 +1366,15 @@ InboundLedger::processData(
             }
         }
 
+        auto nodes = makeNodes(packet);
+
+        ScopedLockType sl(mtx_);
+
         SHAMapAddNode san;
-        receiveNode(packet, san);
+        receiveNode(packet, std::move(nodes), san);
+
+        if (packet.type() == protocol::liAS_NODE)
+            onStateReply(peer->id(), san.getGood());
 
         JLOG(journal_.debug())
             << "Ledger "
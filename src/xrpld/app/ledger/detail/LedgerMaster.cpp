@@ -21,6 +21,7 @@
 #include <xrpld/app/ledger/Ledger.h>
 #include <xrpld/app/ledger/LedgerMaster.h>
 #include <xrpld/app/ledger/LedgerReplayer.h>
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/ledger/OpenLedger.h>
 #include <xrpld/app/ledger/OrderBookDB.h>
 #include <xrpld/app/ledger/PendingSaves.h>
@@ -2178,6 +2179,8 @@ LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
                 {
                     ScopedUnlock sul{sl};
                     app_.getOPs().pubLedger(ledger);
+                    if (auto const stateIndex = app_.getLedgerStateIndex())
+                        stateIndex->onLedger(ledger);
                 }
             }
 
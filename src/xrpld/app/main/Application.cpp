@@ -23,6 +23,7 @@
 #include <xrpld/app/ledger/LedgerCleaner.h>
 #include <xrpld/app/ledger/LedgerMaster.h>
 #include <xrpld/app/ledger/LedgerReplayer.h>
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/ledger/LedgerToJson.h>
 #include <xrpld/app/ledger/OpenLedger.h>
 #include <xrpld/app/ledger/OrderBookDB.h>
@@ -195,6 +196,7 @@ public:
     std::unique_ptr<NodeStore::DatabaseShard> shardStore_;
     std::unique_ptr<ShardFamily> shardFamily_;
     std::unique_ptr<RPC::ShardArchiveHandler> shardArchiveHandler_;
+    std::unique_ptr<LedgerStateIndex> stateIndex_;
     // VFALCO TODO Make OrderBookDB abstract
     OrderBookDB m_orderBookDB;
     std::unique_ptr<PathRequests> m_pathRequests;
@@ -368,6 +370,20 @@ public:
               4,
               logs_->journal("ShardStore")))
 
+        // The state index is optional and only made when configured.
+        , stateIndex_([this]() -> std::unique_ptr<LedgerStateIndex> {
+            auto const& section =
+                config_->section(ConfigSection::nodeDatabase());
+            if (!get<bool>(section, "state_index", false))
+                return {};
+            auto const journal = logs_->journal("StateIndex");
+            return std::make_unique<LedgerStateIndex>(
+                *this,
+                NodeStore::Manager::instance().make_StateIndex(
+                    section, journal),
+                journal);
+        }())
+
         , m_orderBookDB(*this)
 
         , m_pathRequests(std::make_unique<PathRequests>(
@@ -704,6 +720,13 @@ public:
         return shardStore_.get();
     }
 
+    // The state index is an optional feature, like the shard store.
+    LedgerStateIndex*
+    getLedgerStateIndex() override
+    {
+        return stateIndex_.get();
+    }
+
     RPC::ShardArchiveHandler*
     getShardArchiveHandler(bool tryRecovery) override
     {
@@ -79,6 +79,7 @@ class Ledger;
 class LedgerMaster;
 class LedgerCleaner;
 class LedgerReplayer;
+class LedgerStateIndex;
 class LoadManager;
 class ManifestCache;
 class ValidatorKeys;
@@ -214,6 +215,8 @@ public:
     getShardStore() = 0;
     virtual RPC::ShardArchiveHandler*
     getShardArchiveHandler(bool tryRecovery = false) = 0;
+    virtual LedgerStateIndex*
+    getLedgerStateIndex() = 0;
     virtual InboundLedgers&
     getInboundLedgers() = 0;
     virtual InboundTransactions&
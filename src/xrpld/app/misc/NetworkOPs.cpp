@@ -72,6 +72,7 @@
 #include <boost/asio/steady_timer.hpp>
 
 #include <algorithm>
+#include <array>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -81,6 +82,40 @@
 
 namespace ripple {
 
+namespace {
+
+// One shared message per API version of a MultiApiJson. Each version is
+// serialized at most once, however many subscribers it is published to.
+class SharedMultiApiJson
+{
+    using messages_t = std::array<SharedJsonMessage, MultiApiJson::size>;
+
+    messages_t msgs_;
+
+    template <std::size_t... I>
+    static messages_t
+    make(MultiApiJson const& jv, std::index_sequence<I...>)
+    {
+        return {{SharedJsonMessage{jv.val[I]}...}};
+    }
+
+public:
+    explicit SharedMultiApiJson(MultiApiJson const& jv)
+        : msgs_(make(jv, std::make_index_sequence<MultiApiJson::size>{}))
+    {
+    }
+
+    void
+    sendTo(InfoSub& sub, bool broadcast) const
+    {
+        auto const version = sub.getApiVersion();
+        assert(MultiApiJson::valid(version));
+        sub.send(msgs_[MultiApiJson::index(version)], broadcast);
+    }
+};
+
+}  // namespace
+
 class NetworkOPsImp final : public NetworkOPs
 {
     /**
@@ -331,6 +366,16 @@ public:
     void
     apply(std::unique_lock<std::mutex>& batchLock);
 
+    /**
+     * Run preflight for a batch of transactions, in parallel, against the
+     * rules of the open ledger. Needs no locks.
+     *
+     * @param transactions The batch
+     * @return The preflight result of each transaction
+     */
+    std::vector<std::optional<PreflightResult>>
+    preflightBatch(std::vector<TransactionStatus> const& transactions);
+
     //
     // Owner functions.
     //
@@ -1328,6 +1373,10 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
 
     batchLock.unlock();
 
+    // The checks that do not depend on the ledger are done for the whole
+    // batch before taking the locks.
+    auto const preflights = preflightBatch(transactions);
+
     {
         std::unique_lock masterLock{app_.getMasterMutex(), std::defer_lock};
         bool changed = false;
@@ -1337,18 +1386,15 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
             std::lock(masterLock, ledgerLock);
 
             app_.openLedger().modify([&](OpenView& view, beast::Journal j) {
-                for (TransactionStatus& e : transactions)
+                for (std::size_t i = 0; i < transactions.size(); ++i)
                 {
-                    // we check before adding to the batch
-                    ApplyFlags flags = tapNONE;
-                    if (e.admin)
-                        flags |= tapUNLIMITED;
-
-                    if (e.failType == FailHard::yes)
-                        flags |= tapFAIL_HARD;
-
+                    TransactionStatus& e = transactions[i];
                     auto const result = app_.getTxQ().apply(
-                        app_, view, e.transaction->getSTransaction(), flags, j);
+                        app_,
+                        view,
+                        e.transaction->getSTransaction(),
+                        *preflights[i],
+                        j);
                     e.result = result.first;
                     e.applied = result.second;
                     changed = changed || result.second;
@@ -1518,6 +1564,46 @@ NetworkOPsImp::apply(std::unique_lock<std::mutex>& batchLock)
     mDispatchState = DispatchState::none;
 }
 
+std::vector<std::optional<PreflightResult>>
+NetworkOPsImp::preflightBatch(
+    std::vector<TransactionStatus> const& transactions)
+{
+    // Smaller batches are not worth handing to other threads
+    constexpr std::size_t parallelMin = 16;
+
+    auto const rules = app_.openLedger().current()->rules();
+    auto const j = app_.journal("OpenLedger");
+
+    std::vector<std::optional<PreflightResult>> results(transactions.size());
+
+    auto check = [&](std::size_t i) {
+        TransactionStatus const& e = transactions[i];
+
+        // we check before adding to the batch
+        ApplyFlags flags = tapNONE;
+        if (e.admin)
+            flags |= tapUNLIMITED;
+
+        if (e.failType == FailHard::yes)
+            flags |= tapFAIL_HARD;
+
+        STAmountSO stAmountSO{rules.enabled(fixSTAmountCanonicalize)};
+        NumberSO stNumberSO{rules.enabled(fixUniversalNumber)};
+
+        results[i].emplace(preflight(
+            app_, rules, *e.transaction->getSTransaction(), flags, j));
+    };
+
+    m_job_queue.parallelFor(
+        jtTRANSACTION,
+        "NetworkOPs::preflightBatch",
+        transactions.size(),
+        transactions.size() < parallelMin ? 1 : JobQueue::defaultWorkers(),
+        check);
+
+    return results;
+}
+
 //
 // Owner functions
 //
@@ -1980,12 +2066,13 @@ NetworkOPsImp::pubManifest(Manifest const& mo)
             jvObj[jss::domain] = mo.domain;
         jvObj[jss::manifest] = strHex(mo.serialized);
 
+        SharedJsonMessage const msg{jvObj};
         for (auto i = mStreamMaps[sManifests].begin();
              i != mStreamMaps[sManifests].end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2083,6 +2170,7 @@ NetworkOPsImp::pubServer()
 
         mLastFeeSummary = f;
 
+        SharedJsonMessage const msg{jvObj};
         for (auto i = mStreamMaps[sServer].begin();
              i != mStreamMaps[sServer].end();)
         {
@@ -2093,7 +2181,7 @@ NetworkOPsImp::pubServer()
             //             sending of JSON data.
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2116,11 +2204,12 @@ NetworkOPsImp::pubConsensus(ConsensusPhase phase)
         jvObj[jss::type] = "consensusPhase";
         jvObj[jss::consensus] = to_string(phase);
 
+        SharedJsonMessage const msg{jvObj};
         for (auto i = streamMap.begin(); i != streamMap.end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2223,14 +2312,13 @@ NetworkOPsImp::pubValidation(std::shared_ptr<STValidation> const& val)
                 }
             });
 
+        SharedMultiApiJson const msgs{multiObj};
         for (auto i = mStreamMaps[sValidations].begin();
              i != mStreamMaps[sValidations].end();)
         {
             if (auto p = i->second.lock())
             {
-                multiObj.visit(
-                    p->getApiVersion(),  //
-                    [&](Json::Value const& jv) { p->send(jv, true); });
+                msgs.sendTo(*p, true);
                 ++i;
             }
             else
@@ -2252,6 +2340,7 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
         jvObj[jss::type] = "peerStatusChange";
 
+        SharedJsonMessage const msg{jvObj};
         for (auto i = mStreamMaps[sPeerStatus].begin();
              i != mStreamMaps[sPeerStatus].end();)
         {
@@ -2259,7 +2348,7 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++i;
             }
             else
@@ -2761,6 +2850,7 @@ NetworkOPsImp::pubProposedTransaction(
     {
         std::lock_guard sl(mSubLock);
 
+        SharedMultiApiJson const msgs{jvObj};
         auto it = mStreamMaps[sRTTransactions].begin();
         while (it != mStreamMaps[sRTTransactions].end())
         {
@@ -2768,9 +2858,7 @@ NetworkOPsImp::pubProposedTransaction(
 
             if (p)
             {
-                jvObj.visit(
-                    p->getApiVersion(),  //
-                    [&](Json::Value const& jv) { p->send(jv, true); });
+                msgs.sendTo(*p, true);
                 ++it;
             }
             else
@@ -2794,6 +2882,7 @@ NetworkOPsImp::forwardProposedTransaction(Json::Value const& jvObj)
     {
         std::lock_guard sl(mSubLock);
 
+        SharedJsonMessage const msg{jvObj};
         auto it = mStreamMaps[sRTTransactions].begin();
         while (it != mStreamMaps[sRTTransactions].end())
         {
@@ -2801,7 +2890,7 @@ NetworkOPsImp::forwardProposedTransaction(Json::Value const& jvObj)
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
                 ++it;
             }
             else
@@ -2819,12 +2908,13 @@ NetworkOPsImp::forwardValidation(Json::Value const& jvObj)
 {
     std::lock_guard sl(mSubLock);
 
+    SharedJsonMessage const msg{jvObj};
     for (auto i = mStreamMaps[sValidations].begin();
          i != mStreamMaps[sValidations].end();)
     {
         if (auto p = i->second.lock())
         {
-            p->send(jvObj, true);
+            p->send(msg, true);
             ++i;
         }
         else
@@ -2839,12 +2929,13 @@ NetworkOPsImp::forwardManifest(Json::Value const& jvObj)
 {
     std::lock_guard sl(mSubLock);
 
+    SharedJsonMessage const msg{jvObj};
     for (auto i = mStreamMaps[sManifests].begin();
          i != mStreamMaps[sManifests].end();)
     {
         if (auto p = i->second.lock())
         {
-            p->send(jvObj, true);
+            p->send(msg, true);
             ++i;
         }
         else
@@ -2935,8 +3026,9 @@ NetworkOPsImp::forwardProposedAccountTransaction(Json::Value const& jvObj)
 
     if (!notify.empty())
     {
+        SharedJsonMessage const msg{jvObj};
         for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
+            isrListener->send(msg, true);
     }
 }
 
@@ -2957,6 +3049,9 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
 
     assert(alpAccepted->getLedger().get() == lpAccepted.get());
 
+    // Keep the order book index current for pathfinding
+    app_.getOrderBookDB().update(*alpAccepted);
+
     {
         JLOG(m_journal.debug())
             << "Publishing ledger " << lpAccepted->info().seq << " "
@@ -2990,13 +3085,14 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
                     app_.getLedgerMaster().getCompleteLedgers();
             }
 
+            SharedJsonMessage const msg{jvObj};
             auto it = mStreamMaps[sLedger].begin();
             while (it != mStreamMaps[sLedger].end())
             {
                 InfoSub::pointer p = it->second.lock();
                 if (p)
                 {
-                    p->send(jvObj, true);
+                    p->send(msg, true);
                     ++it;
                 }
                 else
@@ -3008,13 +3104,14 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
         {
             Json::Value jvObj = ripple::RPC::computeBookChanges(lpAccepted);
 
+            SharedJsonMessage const msg{jvObj};
             auto it = mStreamMaps[sBookChanges].begin();
             while (it != mStreamMaps[sBookChanges].end())
             {
                 InfoSub::pointer p = it->second.lock();
                 if (p)
                 {
-                    p->send(jvObj, true);
+                    p->send(msg, true);
                     ++it;
                 }
                 else
@@ -3204,6 +3301,7 @@ NetworkOPsImp::pubValidatedTransaction(
     {
         std::lock_guard sl(mSubLock);
 
+        SharedMultiApiJson const msgs{jvObj};
         auto it = mStreamMaps[sTransactions].begin();
         while (it != mStreamMaps[sTransactions].end())
         {
@@ -3211,9 +3309,7 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                jvObj.visit(
-                    p->getApiVersion(),  //
-                    [&](Json::Value const& jv) { p->send(jv, true); });
+                msgs.sendTo(*p, true);
                 ++it;
             }
             else
@@ -3228,9 +3324,7 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                jvObj.visit(
-                    p->getApiVersion(),  //
-                    [&](Json::Value const& jv) { p->send(jv, true); });
+                msgs.sendTo(*p, true);
                 ++it;
             }
             else
@@ -3348,11 +3442,10 @@ NetworkOPsImp::pubAccountTransaction(
         auto const trResult = transaction.getResult();
         MultiApiJson jvObj = transJson(stTxn, trResult, true, ledger, metaRef);
 
-        for (InfoSub::ref isrListener : notify)
         {
-            jvObj.visit(
-                isrListener->getApiVersion(),  //
-                [&](Json::Value const& jv) { isrListener->send(jv, true); });
+            SharedMultiApiJson const msgs{jvObj};
+            for (InfoSub::ref isrListener : notify)
+                msgs.sendTo(*isrListener, true);
         }
 
         if (last)
@@ -3428,10 +3521,11 @@ NetworkOPsImp::pubProposedAccountTransaction(
         // Create two different Json objects, for different API versions
         MultiApiJson jvObj = transJson(tx, result, false, ledger, std::nullopt);
 
-        for (InfoSub::ref isrListener : notify)
-            jvObj.visit(
-                isrListener->getApiVersion(),  //
-                [&](Json::Value const& jv) { isrListener->send(jv, true); });
+        {
+            SharedMultiApiJson const msgs{jvObj};
+            for (InfoSub::ref isrListener : notify)
+                msgs.sendTo(*isrListener, true);
+        }
 
         assert(
             jvObj.isMember(jss::account_history_tx_stream) ==
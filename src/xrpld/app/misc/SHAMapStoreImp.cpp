@@ -19,6 +19,7 @@
 
 #include <xrpld/app/misc/SHAMapStoreImp.h>
 
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/ledger/TransactionMaster.h>
 #include <xrpld/app/misc/NetworkOPs.h>
 #include <xrpld/app/rdb/State.h>
@@ -367,7 +368,7 @@ SHAMapStoreImp::run()
 
             try
             {
-                validatedLedger->stateMap().snapShot(false)->visitNodes(
+                validatedLedger->stateMap().snapShot(false)->visitNodesPrefetch(
                     std::bind(
                         &SHAMapStoreImp::copyNode,
                         this,
@@ -382,7 +383,8 @@ SHAMapStoreImp::run()
                 continue;
             }
 
-            if (healthWait() == stopping)
+            // The walk ends early, without an error, if the node store stops
+            if (healthWait() == stopping || dbRotating_->isStopping())
                 return;
             // Only log if we completed without a "health" abort
             JLOG(journal_.debug()) << "copied ledger " << validatedSeq
@@ -631,6 +633,8 @@ SHAMapStoreImp::clearPrior(LedgerIndex lastRotated)
     ledgerMaster_->clearPriorLedgers(lastRotated);
     JLOG(journal_.trace()) << "End: Clear internal ledgers up to "
                            << lastRotated;
+    if (auto const stateIndex = app_.getLedgerStateIndex())
+        stateIndex->prune(lastRotated);
     if (healthWait() == stopping)
         return;
 
@@ -177,7 +177,7 @@ public:
     minimumOnline() const override;
 
 private:
-    // callback for visitNodes
+    // callback for visitNodesPrefetch
     bool
     copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node);
     void
@@ -275,6 +275,21 @@ public:
         ApplyFlags flags,
         beast::Journal j);
 
+    /**
+        Add a new transaction that was already passed to `preflight`.
+
+        The same as the `apply` above, with the flags taken from the
+        result. `preflight` is only run again if the rules of the view
+        differ from those it was run with.
+    */
+    std::pair<TER, bool>
+    apply(
+        Application& app,
+        OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+        PreflightResult const& preflightResult,
+        beast::Journal j);
+
     /**
         Fill the new open ledger with transactions from the queue.
 
@@ -728,6 +743,17 @@ private:
         FeeMetrics::Snapshot const& metricsSnapshot,
         std::lock_guard<std::mutex> const& lock) const;
 
+    // Implements both TxQ::apply overloads. `preflighted` is the result of
+    // preflight for the transaction, if already known.
+    std::pair<TER, bool>
+    applyImpl(
+        Application& app,
+        OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+        ApplyFlags flags,
+        PreflightResult const* preflighted,
+        beast::Journal j);
+
     // Helper function for TxQ::apply.  If a transaction's fee is high enough,
     // attempt to directly apply that transaction to the ledger.
     std::optional<std::pair<TER, bool>>
@@ -736,6 +762,7 @@ private:
         OpenView& view,
         std::shared_ptr<STTx const> const& tx,
         ApplyFlags flags,
+        PreflightResult const* preflighted,
         beast::Journal j);
 
     // Helper function that removes a replaced entry in _byFee.
@@ -717,13 +717,39 @@ TxQ::apply(
     std::shared_ptr<STTx const> const& tx,
     ApplyFlags flags,
     beast::Journal j)
+{
+    return applyImpl(app, view, tx, flags, nullptr, j);
+}
+
+std::pair<TER, bool>
+TxQ::apply(
+    Application& app,
+    OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+    PreflightResult const& preflightResult,
+    beast::Journal j)
+{
+    assert(&preflightResult.tx == tx.get());
+    return applyImpl(
+        app, view, tx, preflightResult.flags, &preflightResult, j);
+}
+
+std::pair<TER, bool>
+TxQ::applyImpl(
+    Application& app,
+    OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+    ApplyFlags flags,
+    PreflightResult const* preflighted,
+    beast::Journal j)
 {
     STAmountSO stAmountSO{view.rules().enabled(fixSTAmountCanonicalize)};
     NumberSO stNumberSO{view.rules().enabled(fixUniversalNumber)};
 
     // See if the transaction paid a high enough fee that it can go straight
     // into the ledger.
-    if (auto directApplied = tryDirectApply(app, view, tx, flags, j))
+    if (auto directApplied =
+            tryDirectApply(app, view, tx, flags, preflighted, j))
         return *directApplied;
 
     // If we get past tryDirectApply() without returning then we expect
@@ -736,7 +762,9 @@ TxQ::apply(
     // See if the transaction is valid, properly formed,
     // etc. before doing potentially expensive queue
     // replace and multi-transaction operations.
-    auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
+    auto const pfresult = preflighted && preflighted->rules == view.rules()
+        ? *preflighted
+        : preflight(app, view.rules(), *tx, flags, j);
     if (pfresult.ter != tesSUCCESS)
         return {pfresult.ter, false};
 
@@ -1659,6 +1687,7 @@ TxQ::tryDirectApply(
     OpenView& view,
     std::shared_ptr<STTx const> const& tx,
     ApplyFlags flags,
+    PreflightResult const* preflighted,
     beast::Journal j)
 {
     auto const account = (*tx)[sfAccount];
@@ -1693,8 +1722,9 @@ TxQ::tryDirectApply(
         JLOG(j_.trace()) << "Applying transaction " << transactionID
                          << " to open ledger.";
 
-        auto const [txnResult, didApply] =
-            ripple::apply(app, view, *tx, flags, j);
+        auto const [txnResult, didApply] = preflighted
+            ? ripple::apply(app, view, *preflighted)
+            : ripple::apply(app, view, *tx, flags, j);
 
         JLOG(j_.trace()) << "New transaction " << transactionID
                          << (didApply ? " applied successfully with "
@@ -57,6 +57,7 @@ PathRequest::PathRequest(
     , bLastSuccess(false)
     , iIdentifier(id)
     , created_(std::chrono::steady_clock::now())
+    , lastActive_(created_)
 {
     JLOG(m_journal.debug()) << iIdentifier << " created";
 }
@@ -80,6 +81,7 @@ PathRequest::PathRequest(
     , bLastSuccess(false)
     , iIdentifier(id)
     , created_(std::chrono::steady_clock::now())
+    , lastActive_(created_)
 {
     JLOG(m_journal.debug()) << iIdentifier << " created";
 }
@@ -168,6 +170,13 @@ PathRequest::updateComplete()
     }
 }
 
+std::chrono::steady_clock::time_point
+PathRequest::lastActive()
+{
+    std::lock_guard sl(mIndexLock);
+    return lastActive_;
+}
+
 bool
 PathRequest::isValid(std::shared_ptr<RippleLineCache> const& crCache)
 {
@@ -452,6 +461,11 @@ PathRequest::doClose()
 Json::Value
 PathRequest::doStatus(Json::Value const&)
 {
+    {
+        std::lock_guard sl(mIndexLock);
+        lastActive_ = std::chrono::steady_clock::now();
+    }
+
     std::lock_guard sl(mLock);
     jvStatus[jss::status] = jss::success;
     return jvStatus;
@@ -725,7 +739,22 @@ PathRequest::doUpdate(
     JLOG(m_journal.debug()) << iIdentifier << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray, continueCallback))
+    bool const found = findPaths(cache, iLevel, jvArray, continueCallback);
+
+    // A search that was cut short is not a failed one. Keep the last complete
+    // result, if there is one, rather than replace it with a partial one.
+    if (found && continueCallback && !continueCallback())
+    {
+        std::lock_guard sl(mLock);
+        if (jvStatus.isMember(jss::alternatives))
+        {
+            JLOG(m_journal.debug())
+                << iIdentifier << " update interrupted, keeping last result";
+            return jvStatus;
+        }
+    }
+
+    if (found)
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move(jvArray);
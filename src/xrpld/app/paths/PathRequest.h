@@ -85,6 +85,10 @@ public:
     void
     updateComplete();
 
+    // The last time the client created or asked about this request.
+    std::chrono::steady_clock::time_point
+    lastActive();
+
     std::pair<bool, Json::Value>
     doCreate(std::shared_ptr<RippleLineCache> const&, Json::Value const&);
 
@@ -95,7 +99,8 @@ public:
     void
     doAborting() const;
 
-    // update jvStatus
+    // update jvStatus, unless continueCallback stops the search early and
+    // there is an earlier result to keep
     Json::Value
     doUpdate(
         std::shared_ptr<RippleLineCache> const&,
@@ -169,6 +174,7 @@ private:
     std::chrono::steady_clock::time_point const created_;
     std::chrono::steady_clock::time_point quick_reply_;
     std::chrono::steady_clock::time_point full_reply_;
+    std::chrono::steady_clock::time_point lastActive_;
 
     static unsigned int const max_paths_ = 4;
 };
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <xrpld/app/ledger/AcceptedLedger.h>
 #include <xrpld/app/ledger/LedgerMaster.h>
 #include <xrpld/app/main/Application.h>
 #include <xrpld/app/paths/PathRequests.h>
@@ -27,6 +28,7 @@
 #include <xrpl/protocol/jss.h>
 #include <xrpl/resource/Fees.h>
 #include <algorithm>
+#include <condition_variable>
 
 namespace ripple {
 
@@ -38,6 +40,12 @@ PathRequests::getLineCache(
     std::shared_ptr<ReadView const> const& ledger,
     bool authoritative)
 {
+    // Look up the ledger's transactions before taking the lock. They are
+    // only used if they were already gathered when the ledger was published.
+    std::shared_ptr<AcceptedLedger> accepted;
+    if (authoritative && !ledger->open())
+        accepted = app_.getAcceptedLedgerCache().fetch(ledger->info().hash);
+
     std::lock_guard sl(mLock);
 
     auto lineCache = lineCache_.lock();
@@ -58,17 +66,138 @@ PathRequests::getLineCache(
         // Assign to the local before the member, because the member is a
         // weak_ptr, and will immediately discard it if there are no other
         // references.
-        lineCache_ = lineCache = std::make_shared<RippleLineCache>(
-            ledger, app_.journal("RippleLineCache"));
+        lineCache = accepted ? deriveLineCache(ledger, accepted) : nullptr;
+        if (!lineCache)
+            lineCache = std::make_shared<RippleLineCache>(
+                ledger, app_.journal("RippleLineCache"));
+        lineCache_ = lineCache;
+
+        if (authoritative && !ledger->open())
+            closedLineCache_ = lineCache;
     }
     return lineCache;
 }
 
+/** Derive a cache for a closed ledger from the cache for its parent.
+
+    Only the trust lines of accounts touched by the ledger's transactions
+    need to be read again. The caller holds mLock.
+*/
+std::shared_ptr<RippleLineCache>
+PathRequests::deriveLineCache(
+    std::shared_ptr<ReadView const> const& ledger,
+    std::shared_ptr<AcceptedLedger> const& accepted)
+{
+    if (!closedLineCache_ || ledger->open() ||
+        closedLineCache_->getLedger()->info().hash !=
+            ledger->info().parentHash)
+        return {};
+
+    return std::make_shared<RippleLineCache>(
+        *closedLineCache_, *accepted, app_.journal("RippleLineCache"));
+}
+
+namespace {
+
+InfoSub::pointer
+getSubscriber(PathRequest::pointer const& request)
+{
+    if (auto ipSub = request->getSubscriber();
+        ipSub && ipSub->getRequest() == request)
+    {
+        return ipSub;
+    }
+    request->doAborting();
+    return nullptr;
+}
+
+}  // namespace
+
+/** The requests to update in one pass, shared by the jobs updating them.
+
+    Requests are handed out one at a time, in order, until they run out or
+    the pass is interrupted.
+*/
+struct PathRequests::UpdatePass
+{
+    UpdatePass(
+        std::vector<PathRequest::pointer>&& requests_,
+        std::shared_ptr<RippleLineCache> const& cache_,
+        bool newRequests_,
+        std::chrono::milliseconds deadline_)
+        : cache(cache_)
+        , newRequests(newRequests_)
+        , deadline(deadline_)
+        , requests(std::move(requests_))
+    {
+    }
+
+    // Claim the next request, or null if there are no more
+    PathRequest::pointer
+    claim()
+    {
+        std::lock_guard sl(mutex);
+        if (interrupted || next == requests.size())
+            return {};
+        ++active;
+        return requests[next++];
+    }
+
+    // Mark a claimed request as done
+    void
+    finish()
+    {
+        std::lock_guard sl(mutex);
+        if (--active == 0)
+            cv.notify_all();
+    }
+
+    // Stop handing out requests
+    void
+    interrupt()
+    {
+        std::lock_guard sl(mutex);
+        interrupted = true;
+    }
+
+    // Wait for every claimed request to be done
+    void
+    wait()
+    {
+        std::unique_lock sl(mutex);
+        cv.wait(sl, [this] { return active == 0; });
+    }
+
+    std::shared_ptr<RippleLineCache> const cache;
+    bool const newRequests;
+
+    // How long each request may search, or zero for no limit
+    std::chrono::milliseconds const deadline;
+
+    std::atomic<int> processed = 0;
+    std::atomic<int> removed = 0;
+
+    // A new request came in while only older requests were being handled
+    std::atomic<bool> mustBreak = false;
+
+private:
+    std::vector<PathRequest::pointer> const requests;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t next = 0;
+    std::size_t active = 0;
+    bool interrupted = false;
+};
+
 void
 PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
 {
+    using namespace std::chrono;
+
     auto event =
         app_.getJobQueue().makeLoadEvent(jtPATH_FIND, "PathRequest::updateAll");
+    auto const start = steady_clock::now();
 
     std::vector<PathRequest::wptr> requests;
     std::shared_ptr<RippleLineCache> cache;
@@ -83,107 +212,80 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
     bool newRequests = app_.getLedgerMaster().isNewPathRequest();
     bool mustBreak = false;
 
-    JLOG(mJournal.trace()) << "updateAll seq=" << cache->getLedger()->seq()
-                           << ", " << requests.size() << " requests";
+    auto const seq = cache->getLedger()->seq();
+    JLOG(mJournal.trace()) << "updateAll seq=" << seq << ", "
+                           << requests.size() << " requests";
 
-    int processed = 0, removed = 0;
+    auto const& config = app_.config();
 
-    auto getSubscriber =
-        [](PathRequest::pointer const& request) -> InfoSub::pointer {
-        if (auto ipSub = request->getSubscriber();
-            ipSub && ipSub->getRequest() == request)
-        {
-            return ipSub;
-        }
-        request->doAborting();
-        return nullptr;
-    };
+    // Requests are updated by this job and up to workers - 1 more
+    std::size_t const workers = config.PATH_SEARCH_WORKERS > 0
+        ? config.PATH_SEARCH_WORKERS
+        : JobQueue::defaultWorkers();
+
+    // Don't cut searches short when testing or working offline
+    auto const deadline =
+        config.standalone() ? milliseconds{0} : config.PATH_SEARCH_DEADLINE;
+
+    int processed = 0, removed = 0;
 
     do
     {
         JLOG(mJournal.trace()) << "updateAll looping";
+
+        // Give priority to the clients that were active most recently
+        std::vector<std::pair<steady_clock::time_point, PathRequest::pointer>>
+            active;
+        active.reserve(requests.size());
+        bool dangling = false;
         for (auto const& wr : requests)
         {
-            if (app_.getJobQueue().isStopping())
-                break;
+            if (auto request = wr.lock())
+                active.emplace_back(request->lastActive(), std::move(request));
+            else
+                dangling = true;
+        }
+        std::stable_sort(
+            active.begin(), active.end(), [](auto const& a, auto const& b) {
+                return a.first > b.first;
+            });
 
-            auto request = wr.lock();
-            bool remove = true;
-            JLOG(mJournal.trace())
-                << "updateAll request " << (request ? "" : "not ") << "found";
+        if (dangling)
+        {
+            std::lock_guard sl(mLock);
+            auto ret = std::remove_if(
+                requests_.begin(), requests_.end(), [&removed](auto const& wl) {
+                    if (!wl.expired())
+                        return false;
+                    ++removed;
+                    return true;
+                });
+            requests_.erase(ret, requests_.end());
+        }
 
-            if (request)
-            {
-                auto continueCallback = [&getSubscriber, &request]() {
-                    // This callback is used by doUpdate to determine whether to
-                    // continue working. If getSubscriber returns null, that
-                    // indicates that this request is no longer relevant.
-                    return (bool)getSubscriber(request);
-                };
-                if (!request->needsUpdate(
-                        newRequests, cache->getLedger()->seq()))
-                    remove = false;
-                else
-                {
-                    if (auto ipSub = getSubscriber(request))
-                    {
-                        if (!ipSub->getConsumer().warn())
-                        {
-                            // Release the shared ptr to the subscriber so that
-                            // it can be freed if the client disconnects, and
-                            // thus fail to lock later.
-                            ipSub.reset();
-                            Json::Value update = request->doUpdate(
-                                cache, false, continueCallback);
-                            request->updateComplete();
-                            update[jss::type] = "path_find";
-                            if ((ipSub = getSubscriber(request)))
-                            {
-                                ipSub->send(update, false);
-                                remove = false;
-                                ++processed;
-                            }
-                        }
-                    }
-                    else if (request->hasCompletion())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate(cache, false);
-                        request->updateComplete();
-                        ++processed;
-                    }
-                }
-            }
+        std::vector<PathRequest::pointer> ordered;
+        ordered.reserve(active.size());
+        for (auto& entry : active)
+            ordered.push_back(std::move(entry.second));
 
-            if (remove)
-            {
-                std::lock_guard sl(mLock);
-
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if(
-                    requests_.begin(),
-                    requests_.end(),
-                    [&removed, &request](auto const& wl) {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase(ret, requests_.end());
-            }
+        auto const pass = std::make_shared<UpdatePass>(
+            std::move(ordered), cache, newRequests, deadline);
 
-            mustBreak =
-                !newRequests && app_.getLedgerMaster().isNewPathRequest();
+        for (std::size_t i = 1; i < std::min(workers, active.size()); ++i)
+            app_.getJobQueue().addJob(
+                jtPATH_REQUEST, "PathRequest::update", [this, pass]() {
+                    runUpdatePass(*pass);
+                });
 
-            // We weren't handling new requests and then
-            // there was a new request
-            if (mustBreak)
-                break;
-        }
+        runUpdatePass(*pass);
+        pass->wait();
+
+        processed += pass->processed;
+        removed += pass->removed;
+        mustBreak = pass->mustBreak;
+
+        if (app_.getJobQueue().isStopping())
+            break;
 
         if (mustBreak)
         {  // a new request came in while we were working
@@ -215,8 +317,127 @@ PathRequests::updateAll(std::shared_ptr<ReadView const> const& inLedger)
         }
     } while (!app_.getJobQueue().isStopping());
 
-    JLOG(mJournal.debug()) << "updateAll complete: " << processed
-                           << " processed and " << removed << " removed";
+    // Release the line cache once there is nothing left to update, outside
+    // of the lock
+    std::shared_ptr<RippleLineCache> lastCache;
+    {
+        std::lock_guard sl(mLock);
+        if (requests_.empty())
+            lastCache = std::move(closedLineCache_);
+    }
+
+    auto const elapsed =
+        duration_cast<milliseconds>(steady_clock::now() - start);
+    mUpdate.notify(elapsed);
+
+    JLOG(mJournal.debug()) << "updateAll complete for " << seq << ": "
+                           << processed << " processed and " << removed
+                           << " removed in " << elapsed.count() << "ms";
+}
+
+void
+PathRequests::runUpdatePass(UpdatePass& pass)
+{
+    while (auto request = pass.claim())
+    {
+        if (app_.getJobQueue().isStopping())
+        {
+            pass.interrupt();
+        }
+        else
+        {
+            updateRequest(pass, request);
+
+            // We weren't handling new requests and then
+            // there was a new request
+            if (!pass.newRequests && app_.getLedgerMaster().isNewPathRequest())
+            {
+                pass.mustBreak = true;
+                pass.interrupt();
+            }
+        }
+
+        pass.finish();
+    }
+}
+
+void
+PathRequests::updateRequest(
+    UpdatePass& pass,
+    PathRequest::pointer const& request)
+{
+    using namespace std::chrono;
+
+    auto const& cache = pass.cache;
+    bool remove = true;
+
+    auto const deadline = steady_clock::now() + pass.deadline;
+    auto const inTime = [&pass, deadline]() {
+        return pass.deadline == milliseconds{0} ||
+            steady_clock::now() < deadline;
+    };
+
+    auto continueCallback = [&request, &inTime]() {
+        // This callback is used by doUpdate to determine whether to
+        // continue working. If getSubscriber returns null, that
+        // indicates that this request is no longer relevant.
+        return getSubscriber(request) && inTime();
+    };
+
+    if (!request->needsUpdate(pass.newRequests, cache->getLedger()->seq()))
+        remove = false;
+    else
+    {
+        if (auto ipSub = getSubscriber(request))
+        {
+            if (!ipSub->getConsumer().warn())
+            {
+                // Release the shared ptr to the subscriber so that
+                // it can be freed if the client disconnects, and
+                // thus fail to lock later.
+                ipSub.reset();
+                Json::Value update =
+                    request->doUpdate(cache, false, continueCallback);
+                request->updateComplete();
+                update[jss::type] = "path_find";
+                if ((ipSub = getSubscriber(request)))
+                {
+                    ipSub->send(update, false);
+                    remove = false;
+                    ++pass.processed;
+                }
+            }
+        }
+        else if (request->hasCompletion())
+        {
+            // One-shot request with completion function. Its client is
+            // waiting for a single answer, so the search isn't cut short.
+            request->doUpdate(cache, false);
+            request->updateComplete();
+            ++pass.processed;
+        }
+    }
+
+    if (remove)
+    {
+        std::lock_guard sl(mLock);
+
+        // Remove any dangling weak pointers or weak
+        // pointers that refer to this path request.
+        auto ret = std::remove_if(
+            requests_.begin(),
+            requests_.end(),
+            [&pass, &request](auto const& wl) {
+                auto r = wl.lock();
+
+                if (r && r != request)
+                    return false;
+                ++pass.removed;
+                return true;
+            });
+
+        requests_.erase(ret, requests_.end());
+    }
 }
 
 bool
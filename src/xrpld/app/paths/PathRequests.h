@@ -42,10 +42,14 @@ public:
     {
         mFast = collector->make_event("pathfind_fast");
         mFull = collector->make_event("pathfind_full");
+        mUpdate = collector->make_event("pathfind_update");
     }
 
     /** Update all of the contained PathRequest instances.
 
+        The requests are shared among several jobs, which all use the same
+        line cache.
+
         @param ledger Ledger we are pathfinding in.
      */
     void
@@ -99,14 +103,29 @@ public:
     }
 
 private:
+    struct UpdatePass;
+
     void
     insertPathRequest(PathRequest::pointer const&);
 
+    // Update requests from the pass until there are none left
+    void
+    runUpdatePass(UpdatePass& pass);
+
+    void
+    updateRequest(UpdatePass& pass, PathRequest::pointer const& request);
+
+    std::shared_ptr<RippleLineCache>
+    deriveLineCache(
+        std::shared_ptr<ReadView const> const& ledger,
+        std::shared_ptr<AcceptedLedger> const& accepted);
+
     Application& app_;
     beast::Journal mJournal;
 
     beast::insight::Event mFast;
     beast::insight::Event mFull;
+    beast::insight::Event mUpdate;
 
     // Track all requests
     std::vector<PathRequest::wptr> requests_;
@@ -114,6 +133,10 @@ private:
     // Use a RippleLineCache
     std::weak_ptr<RippleLineCache> lineCache_;
 
+    // The cache for the last closed ledger, kept while there are requests so
+    // that the cache for the next ledger can be derived from it
+    std::shared_ptr<RippleLineCache> closedLineCache_;
+
     std::atomic<int> mLastIdentifier;
 
     std::recursive_mutex mutable mLock;
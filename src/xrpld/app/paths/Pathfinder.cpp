@@ -318,10 +318,11 @@ Pathfinder::findPaths(
     }
 
     // Now iterate over all paths for that paymentType.
+    // If the search is cut short, keep the paths found so far
     for (auto const& costedPath : mPathTable[paymentType])
     {
         if (continueCallback && !continueCallback())
-            return false;
+            break;
         // Only use paths with at most the current search level.
         if (costedPath.searchLevel <= searchLevel)
         {
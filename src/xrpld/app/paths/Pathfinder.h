@@ -56,6 +56,12 @@ public:
     static void
     initPathTable();
 
+    /** Search for paths, up to the given search level.
+
+        Returns false if no payment can be made between the accounts. If
+        continueCallback returns false, the search stops early and the paths
+        found so far are kept.
+    */
     bool
     findPaths(
         int searchLevel,
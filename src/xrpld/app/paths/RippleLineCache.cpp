@@ -31,6 +31,59 @@ RippleLineCache::RippleLineCache(
     JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq;
 }
 
+RippleLineCache::RippleLineCache(
+    RippleLineCache const& parent,
+    AcceptedLedger const& accepted,
+    beast::Journal j)
+    : hasher_(parent.hasher_), ledger_(accepted.getLedger()), journal_(j)
+{
+    assert(ledger_->info().parentHash == parent.ledger_->info().hash);
+
+    // Find the accounts whose trust lines were created, changed or deleted
+    hash_set<AccountID> touched;
+    for (auto const& tx : accepted)
+    {
+        for (auto const& node : tx->getMeta().getNodes())
+        {
+            if (node.getFieldU16(sfLedgerEntryType) != ltRIPPLE_STATE)
+                continue;
+
+            auto const data = dynamic_cast<STObject const*>(node.peekAtPField(
+                node.getFName() == sfCreatedNode ? sfNewFields
+                                                 : sfFinalFields));
+            if (!data || !data->isFieldPresent(sfLowLimit) ||
+                !data->isFieldPresent(sfHighLimit))
+            {
+                JLOG(journal_.warn())
+                    << "Unable to identify trust line owners in ledger "
+                    << ledger_->info().seq;
+                return;
+            }
+
+            touched.insert(data->getFieldAmount(sfLowLimit).getIssuer());
+            touched.insert(data->getFieldAmount(sfHighLimit).getIssuer());
+        }
+    }
+
+    std::lock_guard sl(parent.mLock);
+
+    lines_.reserve(parent.lines_.size());
+    for (auto const& [key, lines] : parent.lines_)
+    {
+        if (touched.count(key.account_))
+            continue;
+
+        lines_.emplace(key, lines);
+        if (lines)
+            totalLineCount_ += lines->size();
+    }
+
+    JLOG(journal_.debug()) << "created for ledger " << ledger_->info().seq
+                           << " reusing " << lines_.size() << " of "
+                           << parent.lines_.size() << " accounts from ledger "
+                           << parent.ledger_->info().seq;
+}
+
 RippleLineCache::~RippleLineCache()
 {
     JLOG(journal_.debug()) << "destroyed for ledger " << ledger_->info().seq
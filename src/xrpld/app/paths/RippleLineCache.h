@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_PATHS_RIPPLELINECACHE_H_INCLUDED
 #define RIPPLE_APP_PATHS_RIPPLELINECACHE_H_INCLUDED
 
+#include <xrpld/app/ledger/AcceptedLedger.h>
 #include <xrpld/app/ledger/Ledger.h>
 #include <xrpld/app/paths/TrustLine.h>
 #include <xrpl/basics/CountedObject.h>
@@ -39,6 +40,20 @@ public:
     explicit RippleLineCache(
         std::shared_ptr<ReadView const> const& l,
         beast::Journal j);
+
+    /** Create a cache for a ledger that follows the one of another cache.
+
+        Trust lines of accounts not touched by the ledger's transactions are
+        carried over from the parent, so they need not be read again.
+
+        @param parent The cache for the ledger's parent.
+        @param accepted The ledger, with its transactions and metadata.
+    */
+    RippleLineCache(
+        RippleLineCache const& parent,
+        AcceptedLedger const& accepted,
+        beast::Journal j);
+
     ~RippleLineCache();
 
     std::shared_ptr<ReadView const> const&
@@ -63,7 +78,7 @@ public:
     getRippleLines(AccountID const& accountID, LineDirection direction);
 
 private:
-    std::mutex mLock;
+    std::mutex mutable mLock;
 
     ripple::hardened_hash<> hasher_;
     std::shared_ptr<ReadView const> ledger_;
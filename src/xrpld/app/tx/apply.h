@@ -27,11 +27,13 @@
 #include <xrpl/protocol/TER.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
 class Application;
 class HashRouter;
+struct PreflightResult;
 
 /** Describes the pre-processing validity of a transaction.
 
@@ -66,6 +68,20 @@ checkValidity(
     Rules const& rules,
     Config const& config);
 
+/** Checks the signatures of many transactions.
+
+    The result of each check is cached as it would be by `checkValidity`,
+    which then does not check the signature again. Transactions whose
+    signature state is already cached are skipped.
+
+    @see checkValidity
+*/
+void
+checkSignatures(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules);
+
 /** Sets the validity of a given transaction in the cache.
 
     @warning Use with extreme care.
@@ -127,6 +143,29 @@ apply(
     ApplyFlags flags,
     beast::Journal journal);
 
+/** Apply a transaction to an `OpenView`, given its `preflight` result.
+
+    The same as the `apply` above, for a transaction that was already
+    passed to `preflight`, perhaps on another thread. `preflight` is only
+    run again if the rules of the view differ from those it was run with.
+
+    @param app The current running `Application`.
+    @param view The open ledger that the transaction
+        will attempt to be applied to.
+    @param preflightResult The result of `preflight`, which holds the
+        transaction, the flags and the journal.
+
+    @see preflight, preclaim, doApply
+
+    @return A pair with the `TER` and a `bool` indicating
+            whether or not the transaction was applied.
+*/
+std::pair<TER, bool>
+apply(
+    Application& app,
+    OpenView& view,
+    PreflightResult const& preflightResult);
+
 /** Enum class for return value from `applyTransaction`
 
     @see applyTransaction
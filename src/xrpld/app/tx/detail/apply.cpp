@@ -85,6 +85,30 @@ checkValidity(
     return {Validity::Valid, ""};
 }
 
+void
+checkSignatures(
+    HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+    Rules const& rules)
+{
+    auto const requireCanonicalSig =
+        rules.enabled(featureRequireFullyCanonicalSig)
+        ? STTx::RequireFullyCanonicalSig::yes
+        : STTx::RequireFullyCanonicalSig::no;
+
+    for (auto const& tx : txs)
+    {
+        auto const id = tx->getTransactionID();
+        if (router.getFlags(id) & (SF_SIGBAD | SF_SIGGOOD))
+            continue;
+
+        router.setFlags(
+            id,
+            tx->checkSign(requireCanonicalSig, rules) ? SF_SIGGOOD
+                                                      : SF_SIGBAD);
+    }
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid, Validity validity)
 {
@@ -121,6 +145,20 @@ apply(
     return doApply(pcresult, app, view);
 }
 
+std::pair<TER, bool>
+apply(
+    Application& app,
+    OpenView& view,
+    PreflightResult const& preflightResult)
+{
+    STAmountSO stAmountSO{view.rules().enabled(fixSTAmountCanonicalize)};
+    NumberSO stNumberSO{view.rules().enabled(fixUniversalNumber)};
+
+    // preclaim runs preflight again if the rules have changed
+    auto pcresult = preclaim(preflightResult, app, view);
+    return doApply(pcresult, app, view);
+}
+
 ApplyResult
 applyTransaction(
     Application& app,
@@ -209,6 +209,12 @@ public:
     int PATH_SEARCH_FAST = 2;
     int PATH_SEARCH_MAX = 3;
 
+    // Path finding subscriptions are updated after each ledger by at most
+    // this many jobs at once (zero picks a value from the hardware), and
+    // each request may search for at most this long per update.
+    int PATH_SEARCH_WORKERS = 0;
+    std::chrono::milliseconds PATH_SEARCH_DEADLINE{5000};
+
     // Validation
     std::optional<std::size_t>
         VALIDATION_QUORUM;  // validations to consider ledger authoritative
@@ -247,6 +253,9 @@ public:
     int IO_WORKERS = 0;        // io svc thread count. default: 2
     int PREFETCH_WORKERS = 0;  // prefetch thread count. default: 4
 
+    // Threads applying consensus transactions to a new ledger (1 = serial)
+    int LEDGER_BUILD_WORKERS = 1;
+
     // Can only be set in code, specifically unit tests
     bool FORCE_MULTI_THREAD = false;
 
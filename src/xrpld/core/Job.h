@@ -41,6 +41,7 @@ enum JobType {
     // insert a job at a specific priority, simply add it at the right location.
 
     jtPACK,               // Make a fetch pack for a peer
+    jtLEDGER_PREFETCH,    // Load a ledger a peer is likely to ask for next
     jtPUBOLDLEDGER,       // An old ledger has been accepted
     jtCLIENT,             // A placeholder for the priority of all jtCLIENT jobs
     jtCLIENT_SUBSCRIBE,   // A websocket subscription by a client
@@ -55,6 +56,7 @@ enum JobType {
     jtVALIDATION_ut,      // A validation from an untrusted source
     jtMANIFEST,           // A validator's manifest
     jtUPDATE_PF,          // Update pathfinding requests
+    jtPATH_REQUEST,       // Update a share of the pathfinding requests
     jtTRANSACTION_l,      // A local transaction
     jtREPLAY_REQ,         // Peer request a ledger delta or a skip list
     jtLEDGER_REQ,         // Peer request ledger/txnset data
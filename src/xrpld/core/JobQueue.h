@@ -29,6 +29,13 @@
 #include <boost/coroutine/all.hpp>
 #include <boost/range/begin.hpp>  // workaround for boost 1.72 bug
 #include <boost/range/end.hpp>    // workaround for boost 1.72 bug
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -186,6 +193,39 @@ public:
     std::shared_ptr<Coro>
     postCoro(JobType t, std::string const& name, F&& f);
 
+    /** Calls a function for each index in a range, in parallel.
+
+        The calling thread does part of the work, helped by up to
+        `workers - 1` jobs. It keeps taking indices until none are left, so
+        the call completes even if no job gets to run. Jobs that start after
+        that return at once. The function must be safe to call concurrently.
+
+        @param t The type of the helper jobs.
+        @param name Name of the helper jobs.
+        @param n The number of indices, starting from zero.
+        @param workers The most threads to use, including this one.
+        @param f Has a signature of void(std::size_t).
+
+        If f throws, the first exception is rethrown once all the calls
+        that were started have returned.
+    */
+    template <class F>
+    void
+    parallelFor(
+        JobType t,
+        std::string const& name,
+        std::size_t n,
+        std::size_t workers,
+        F&& f);
+
+    /** The number of threads to use for parallel work by default.
+
+        This is half the hardware threads, leaving the rest for other jobs,
+        and at least one.
+    */
+    static std::size_t
+    defaultWorkers();
+
     /** Jobs waiting at this priority.
      */
     int
@@ -243,17 +283,32 @@ private:
     using JobDataMap = std::map<JobType, JobTypeData>;
 
     beast::Journal m_journal;
+
+    // Guards nSuspend_ and the idle notification. Each job type queues its
+    // jobs under its own lock in JobTypeData, so adding and running jobs of
+    // different types do not contend with each other.
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    std::set<Job> m_jobSet;
+    std::atomic<std::uint64_t> m_lastJob;
     JobCounter jobCounter_;
     std::atomic_bool stopping_{false};
     std::atomic_bool stopped_{false};
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
+    // The job types that can be dispatched, highest priority first
+    std::vector<JobTypeData*> m_dispatch;
+
+    // The number of jobs waiting, of all types
+    std::atomic<int> m_jobCount;
+
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic<int> m_processCount;
+
+    // Changes whenever a job may have become runnable
+    std::atomic<std::uint64_t> readySeq_{0};
+
+    // The number of workers waiting on cv_ for a job to become runnable
+    std::atomic<int> idleWorkers_{0};
 
     // The number of suspended coroutines
     int nSuspend_ = 0;
@@ -287,30 +342,37 @@ private:
         std::string const& name,
         JobFunction const& func);
 
-    // Returns the next Job we should run now.
+    // Takes the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A queued Job whose slots count for its type is greater than zero.
     //
-    // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    // The job types are visited from the highest priority down and the
+    // oldest RunnableJob of the first type that has one is taken.
     //
     // Post-conditions:
+    //  Returns false if no RunnableJob was found. Otherwise:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from the queue of its type.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
     // Invariants:
-    //  The calling thread owns the JobLock
-    void
+    //  The calling thread owns no JobTypeData lock
+    bool
     getNextJob(Job& job);
 
+    // Wakes the workers waiting for a job to become runnable, if any.
+    //
+    // Called after a job is queued or finishes, without holding any
+    // JobTypeData lock.
+    void
+    jobReady();
+
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not exist in the queue of its type.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -326,7 +388,7 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A task was added for a RunnableJob
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -335,12 +397,6 @@ private:
     //  <none>
     void
     processTask(int instance) override;
-
-    // Returns the limit of running jobs for the given job type.
-    // For jobs with no limit, we return the largest int. Hopefully that
-    // will be enough.
-    int
-    getJobLimit(JobType type);
 };
 
 /*
@@ -426,6 +482,68 @@ JobQueue::postCoro(JobType t, std::string const& name, F&& f)
     return coro;
 }
 
+template <class F>
+void
+JobQueue::parallelFor(
+    JobType t,
+    std::string const& name,
+    std::size_t n,
+    std::size_t workers,
+    F&& f)
+{
+    struct State
+    {
+        std::atomic<std::size_t> next{0};
+        std::size_t done = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto const state = std::make_shared<State>();
+    auto const fp = &f;
+
+    // Take indices until none are left. Late jobs find none and never call
+    // f, which may no longer exist by then.
+    auto run = [state, fp, n]() {
+        std::size_t ran = 0;
+        std::exception_ptr error;
+        for (auto i = state->next++; i < n; i = state->next++)
+        {
+            try
+            {
+                (*fp)(i);
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+            ++ran;
+        }
+
+        if (ran == 0)
+            return;
+
+        std::lock_guard lock(state->mutex);
+        if (error && !state->error)
+            state->error = error;
+        state->done += ran;
+        if (state->done == n)
+            state->cv.notify_all();
+    };
+
+    for (std::size_t i = 1; i < std::min(workers, n); ++i)
+        addJob(t, name, run);
+
+    run();
+
+    std::unique_lock lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->done == n; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
 }  // namespace ripple
 
 #endif
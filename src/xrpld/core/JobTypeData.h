@@ -20,9 +20,13 @@
 #ifndef RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
+#include <xrpld/core/Job.h>
 #include <xrpld/core/JobTypeInfo.h>
 #include <xrpl/basics/Log.h>
 #include <xrpl/beast/insight/Collector.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
 
 namespace ripple {
 
@@ -38,8 +42,15 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
+    /* Guards the queue and the counts below, except for lock-free reads
+       of waiting */
+    mutable std::mutex mutex;
+
+    /* The jobs waiting to run, oldest first */
+    std::deque<Job> jobs;
+
     /* The number of jobs waiting */
-    int waiting;
+    std::atomic<int> waiting;
 
     /* The number presently running */
     int running;
@@ -70,6 +70,7 @@ private:
         //                                                           avg     peak
         //  JobType               name                    limit    latency  latency
         add(jtPACK,              "makeFetchPack",               1,     0ms,     0ms);
+        add(jtLEDGER_PREFETCH,   "prefetchLedger",              2,     0ms,     0ms);
         add(jtPUBOLDLEDGER,      "publishAcqLedger",            2, 10000ms, 15000ms);
         add(jtVALIDATION_ut,     "untrustedValidation",  maxLimit,  2000ms,  5000ms);
         add(jtMANIFEST,          "manifest",             maxLimit,  2000ms,  5000ms);
@@ -89,6 +90,7 @@ private:
         add(jtCLIENT_WEBSOCKET,  "clientWebsocket",      maxLimit,  2000ms,  5000ms);
         add(jtRPC,               "RPC",                  maxLimit,     0ms,     0ms);
         add(jtUPDATE_PF,         "updatePaths",                 1,     0ms,     0ms);
+        add(jtPATH_REQUEST,      "pathRequest",          maxLimit,     0ms,     0ms);
         add(jtTRANSACTION,       "transaction",          maxLimit,   250ms,  1000ms);
         add(jtBATCH,             "batch",                maxLimit,   250ms,  1000ms);
         add(jtADVANCE,           "advanceLedger",        maxLimit,     0ms,     0ms);
@@ -654,6 +654,11 @@ Config::loadFromString(std::string const& fileContents)
         PATH_SEARCH_FAST = beast::lexicalCastThrow<int>(strTemp);
     if (getSingleSection(secConfig, SECTION_PATH_SEARCH_MAX, strTemp, j_))
         PATH_SEARCH_MAX = beast::lexicalCastThrow<int>(strTemp);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_WORKERS, strTemp, j_))
+        PATH_SEARCH_WORKERS = beast::lexicalCastThrow<int>(strTemp);
+    if (getSingleSection(secConfig, SECTION_PATH_SEARCH_DEADLINE, strTemp, j_))
+        PATH_SEARCH_DEADLINE = std::chrono::milliseconds(
+            beast::lexicalCastThrow<std::uint32_t>(strTemp));
 
     if (getSingleSection(secConfig, SECTION_DEBUG_LOGFILE, strTemp, j_))
         DEBUG_LOGFILE = strTemp;
@@ -697,6 +702,16 @@ Config::loadFromString(std::string const& fileContents)
                 ": must be between 1 and 1024 inclusive.");
     }
 
+    if (getSingleSection(secConfig, SECTION_LEDGER_BUILD_WORKERS, strTemp, j_))
+    {
+        LEDGER_BUILD_WORKERS = beast::lexicalCastThrow<int>(strTemp);
+
+        if (LEDGER_BUILD_WORKERS < 1 || LEDGER_BUILD_WORKERS > 1024)
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_LEDGER_BUILD_WORKERS
+                ": must be between 1 and 1024 inclusive.");
+    }
+
     if (getSingleSection(secConfig, SECTION_COMPRESSION, strTemp, j_))
         COMPRESSION = beast::lexicalCastThrow<bool>(strTemp);
 
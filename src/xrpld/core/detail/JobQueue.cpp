@@ -20,7 +20,9 @@
 #include <xrpld/core/JobQueue.h>
 #include <xrpld/perflog/PerfLog.h>
 #include <xrpl/basics/contract.h>
+#include <algorithm>
 #include <mutex>
+#include <thread>
 
 namespace ripple {
 
@@ -33,6 +35,7 @@ JobQueue::JobQueue(
     : m_journal(journal)
     , m_lastJob(0)
     , m_invalidJobData(JobTypes::instance().getInvalid(), collector, logs)
+    , m_jobCount(0)
     , m_processCount(0)
     , m_workers(*this, &perfLog, "JobQueue", threadCount)
     , perfLog_(perfLog)
@@ -58,6 +61,13 @@ JobQueue::JobQueue(
             assert(result.second == true);
             (void)result.second;
         }
+
+        // Job types without slots are never dispatched by the pool
+        for (auto iter = m_jobData.rbegin(); iter != m_jobData.rend(); ++iter)
+        {
+            if (iter->second.info.limit() > 0)
+                m_dispatch.push_back(&iter->second);
+        }
     }
 }
 
@@ -70,8 +80,7 @@ JobQueue::~JobQueue()
 void
 JobQueue::collect()
 {
-    std::lock_guard lock(m_mutex);
-    job_count = m_jobSet.size();
+    job_count = m_jobCount.load();
 }
 
 bool
@@ -97,51 +106,57 @@ JobQueue::addRefCountedJob(
         (type >= jtCLIENT && type <= jtCLIENT_WEBSOCKET) ||
         m_workers.getNumberOfThreads() > 0);
 
+    bool runNow;
     {
-        std::lock_guard lock(m_mutex);
-        auto result =
-            m_jobSet.emplace(type, name, ++m_lastJob, data.load(), func);
-        auto const& job = *result.first;
-
-        JobType const type(job.getType());
-        assert(type != jtINVALID);
-        assert(m_jobSet.find(job) != m_jobSet.end());
+        std::lock_guard lock(data.mutex);
+        data.jobs.emplace_back(type, name, ++m_lastJob, data.load(), func);
         perfLog_.jobQueue(type);
 
-        JobTypeData& data(getJobTypeData(type));
-
-        if (data.waiting + data.running < getJobLimit(type))
-        {
-            m_workers.addTask();
-        }
-        else
+        runNow = data.waiting + data.running < data.info.limit();
+        if (!runNow)
         {
             // defer the task until we go below the limit
             ++data.deferred;
         }
         ++data.waiting;
+        ++m_jobCount;
     }
+
+    jobReady();
+    if (runNow)
+        m_workers.addTask();
     return true;
 }
 
+void
+JobQueue::jobReady()
+{
+    ++readySeq_;
+    if (idleWorkers_.load() != 0)
+    {
+        std::lock_guard lock(m_mutex);
+        cv_.notify_all();
+    }
+}
+
 int
 JobQueue::getJobCount(JobType t) const
 {
-    std::lock_guard lock(m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find(t);
 
-    return (c == m_jobData.end()) ? 0 : c->second.waiting;
+    return (c == m_jobData.end()) ? 0 : c->second.waiting.load();
 }
 
 int
 JobQueue::getJobCountTotal(JobType t) const
 {
-    std::lock_guard lock(m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find(t);
 
-    return (c == m_jobData.end()) ? 0 : (c->second.waiting + c->second.running);
+    if (c == m_jobData.end())
+        return 0;
+
+    std::lock_guard lock(c->second.mutex);
+    return c->second.waiting + c->second.running;
 }
 
 int
@@ -150,8 +165,6 @@ JobQueue::getJobCountGE(JobType t) const
     // return the number of jobs at this priority level or greater
     int ret = 0;
 
-    std::lock_guard lock(m_mutex);
-
     for (auto const& x : m_jobData)
     {
         if (x.first >= t)
@@ -184,6 +197,12 @@ JobQueue::addLoadEvents(JobType t, int count, std::chrono::milliseconds elapsed)
     iter->second.load().addSamples(count, elapsed);
 }
 
+std::size_t
+JobQueue::defaultWorkers()
+{
+    return std::max(1u, std::thread::hardware_concurrency() / 2);
+}
+
 bool
 JobQueue::isOverloaded()
 {
@@ -202,8 +221,6 @@ JobQueue::getJson(int c)
 
     Json::Value priorities = Json::arrayValue;
 
-    std::lock_guard lock(m_mutex);
-
     for (auto& x : m_jobData)
     {
         assert(x.first != jtINVALID);
@@ -215,8 +232,13 @@ JobQueue::getJson(int c)
 
         LoadMonitor::Stats stats(data.stats());
 
-        int waiting(data.waiting);
-        int running(data.running);
+        int waiting;
+        int running;
+        {
+            std::lock_guard lock(data.mutex);
+            waiting = data.waiting;
+            running = data.running;
+        }
 
         if ((stats.count != 0) || (waiting != 0) ||
             (stats.latencyPeak != 0ms) || (running != 0))
@@ -254,7 +276,7 @@ void
 JobQueue::rendezvous()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+    cv_.wait(lock, [this] { return m_processCount == 0 && m_jobCount == 0; });
 }
 
 JobTypeData&
@@ -285,9 +307,9 @@ JobQueue::stop()
         // we must wait on the condition variable to make these assertions.
         std::unique_lock<std::mutex> lock(m_mutex);
         cv_.wait(
-            lock, [this] { return m_processCount == 0 && m_jobSet.empty(); });
+            lock, [this] { return m_processCount == 0 && m_jobCount == 0; });
         assert(m_processCount == 0);
-        assert(m_jobSet.empty());
+        assert(m_jobCount == 0);
         assert(nSuspend_ == 0);
         stopped_ = true;
     }
@@ -299,33 +321,32 @@ JobQueue::isStopped() const
     return stopped_;
 }
 
-void
+bool
 JobQueue::getNextJob(Job& job)
 {
-    assert(!m_jobSet.empty());
-
-    std::set<Job>::const_iterator iter;
-    for (iter = m_jobSet.begin(); iter != m_jobSet.end(); ++iter)
+    for (JobTypeData* data : m_dispatch)
     {
-        JobType const type = iter->getType();
-        assert(type != jtINVALID);
+        // Skip idle types without taking their lock
+        if (data->waiting.load(std::memory_order_relaxed) == 0)
+            continue;
 
-        JobTypeData& data(getJobTypeData(type));
-        assert(data.running <= getJobLimit(type));
+        std::lock_guard lock(data->mutex);
+        assert(data->running <= data->info.limit());
 
         // Run this job if we're running below the limit.
-        if (data.running < getJobLimit(data.type()))
-        {
-            assert(data.waiting > 0);
-            --data.waiting;
-            ++data.running;
-            break;
-        }
+        if (data->jobs.empty() || data->running >= data->info.limit())
+            continue;
+
+        assert(data->waiting > 0);
+        --data->waiting;
+        ++data->running;
+        --m_jobCount;
+        job = std::move(data->jobs.front());
+        data->jobs.pop_front();
+        return true;
     }
 
-    assert(iter != m_jobSet.end());
-    job = *iter;
-    m_jobSet.erase(iter);
+    return false;
 }
 
 void
@@ -335,16 +356,25 @@ JobQueue::finishJob(JobType type)
 
     JobTypeData& data = getJobTypeData(type);
 
-    // Queue a deferred task if possible
-    if (data.deferred > 0)
+    bool deferred = false;
     {
-        assert(data.running + data.waiting >= getJobLimit(type));
+        std::lock_guard lock(data.mutex);
 
-        --data.deferred;
-        m_workers.addTask();
+        // Queue a deferred task if possible
+        if (data.deferred > 0)
+        {
+            assert(data.running + data.waiting >= data.info.limit());
+
+            --data.deferred;
+            deferred = true;
+        }
+
+        --data.running;
     }
 
-    --data.running;
+    jobReady();
+    if (deferred)
+        m_workers.addTask();
 }
 
 void
@@ -357,11 +387,26 @@ JobQueue::processTask(int instance)
         Job::clock_type::time_point const start_time(Job::clock_type::now());
         {
             Job job;
+
+            // Counted before the job leaves its queue so that rendezvous()
+            // never sees the queue empty while the job is in flight.
+            ++m_processCount;
+
+            // Every task is added for a runnable job, but the types are not
+            // locked together: another worker may take the job this task
+            // was added for before we reach it, and then the job its own
+            // task was added for becomes ours. That job only becomes
+            // runnable after our scan has passed its type, so wait for it
+            // rather than scanning again at once.
+            for (auto seq = readySeq_.load(); !getNextJob(job);
+                 seq = readySeq_.load())
             {
-                std::lock_guard lock(m_mutex);
-                getNextJob(job);
-                ++m_processCount;
+                std::unique_lock lock(m_mutex);
+                ++idleWorkers_;
+                cv_.wait(lock, [&] { return readySeq_.load() != seq; });
+                --idleWorkers_;
             }
+
             type = job.getType();
             JobTypeData& data(getJobTypeData(type));
             JLOG(m_journal.trace()) << "Doing " << data.name() << "job";
@@ -386,27 +431,20 @@ JobQueue::processTask(int instance)
         }
     }
 
+    // Job should be destroyed before stopping
+    // otherwise destructors with side effects can access
+    // parent objects that are already destroyed.
+    finishJob(type);
+    if (--m_processCount == 0 && m_jobCount == 0)
     {
+        // Lock so that a waiter cannot miss the notification between
+        // testing its predicate and blocking.
         std::lock_guard lock(m_mutex);
-        // Job should be destroyed before stopping
-        // otherwise destructors with side effects can access
-        // parent objects that are already destroyed.
-        finishJob(type);
-        if (--m_processCount == 0 && m_jobSet.empty())
-            cv_.notify_all();
+        cv_.notify_all();
     }
 
     // Note that when Job::~Job is called, the last reference
     // to the associated LoadEvent object (in the Job) may be destroyed.
 }
 
-int
-JobQueue::getJobLimit(JobType type)
-{
-    JobTypeInfo const& j(JobTypes::instance().get(type));
-    assert(j.type() != jtINVALID);
-
-    return j.limit();
-}
-
 }  // namespace ripple
@@ -26,7 +26,9 @@
 #include <xrpl/protocol/Book.h>
 #include <xrpl/protocol/ErrorCodes.h>
 #include <xrpl/resource/Consumer.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -46,6 +48,38 @@ public:
     doStatus(Json::Value const&) = 0;
 };
 
+/** A JSON message published to many subscribers.
+
+    The message is serialized at most once, the first time a subscriber
+    asks for its text, and the resulting buffer is shared by every
+    subscriber the message is sent to. This is not thread safe; a message
+    is built and fanned out by a single publishing thread.
+*/
+class SharedJsonMessage
+{
+    Json::Value const& jv_;
+    mutable std::shared_ptr<std::string const> text_;
+
+public:
+    explicit SharedJsonMessage(Json::Value const& jv) : jv_(jv)
+    {
+    }
+
+    SharedJsonMessage(SharedJsonMessage const&) = delete;
+    SharedJsonMessage&
+    operator=(SharedJsonMessage const&) = delete;
+
+    Json::Value const&
+    json() const
+    {
+        return jv_;
+    }
+
+    /** Return the serialized message, serializing it on first use. */
+    std::shared_ptr<std::string const> const&
+    text() const;
+};
+
 /** Manages a client's subscription to data feeds.
  */
 class InfoSub : public CountedObject<InfoSub>
@@ -201,6 +235,14 @@ public:
     virtual void
     send(Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message that may be shared with other subscribers.
+
+        Subscribers which can write the serialized text directly should
+        override this; the default sends the JSON value.
+    */
+    virtual void
+    send(SharedJsonMessage const& msg, bool broadcast);
+
     std::uint64_t
     getSeq();
 
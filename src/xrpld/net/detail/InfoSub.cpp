@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <xrpld/net/InfoSub.h>
+#include <xrpl/json/json_writer.h>
 #include <atomic>
 
 namespace ripple {
@@ -33,6 +34,22 @@ namespace ripple {
 // code assumes this node is synched (and will continue to do so until
 // there's a functional network.
 
+std::shared_ptr<std::string const> const&
+SharedJsonMessage::text() const
+{
+    if (!text_)
+    {
+        auto s = std::make_shared<std::string>();
+        Json::stream(jv_, [&s](void const* data, std::size_t n) {
+            s->append(static_cast<char const*>(data), n);
+        });
+        text_ = std::move(s);
+    }
+    return text_;
+}
+
+//------------------------------------------------------------------------------
+
 InfoSub::InfoSub(Source& source) : m_source(source), mSeq(assign_id())
 {
 }
@@ -71,6 +88,12 @@ InfoSub::getConsumer()
     return m_consumer;
 }
 
+void
+InfoSub::send(SharedJsonMessage const& msg, bool broadcast)
+{
+    send(msg.json(), broadcast);
+}
+
 std::uint64_t
 InfoSub::getSeq()
 {
@@ -144,6 +144,19 @@ public:
         FetchType fetchType = FetchType::synchronous,
         bool duplicate = false);
 
+    /** Fetch a batch of node objects.
+        The cache is checked first, and the objects that are not in it are
+        read from the backend together, which lets the backend overlap the
+        reads. The default implementation fetches the objects one at a time.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @return The objects, in the order of the keys, with nullptr for each
+                object that couldn't be retrieved.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch(std::vector<uint256> const& hashes);
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -22,6 +22,7 @@
 
 #include <xrpld/nodestore/Backend.h>
 #include <xrpld/nodestore/Scheduler.h>
+#include <xrpld/nodestore/StateIndex.h>
 #include <xrpl/beast/utility/Journal.h>
 #include <nudb/store.hpp>
 
@@ -75,6 +76,18 @@ public:
     {
         return {};
     }
+
+    /** Create a flat state index stored alongside this factory's backend.
+
+        @param parameters A set of key/value configuration pairs.
+        @return A pointer to the StateIndex object, or `nullptr` if this
+                factory does not support one.
+    */
+    virtual std::unique_ptr<StateIndex>
+    createStateIndex(Section const& parameters, beast::Journal journal)
+    {
+        return {};
+    }
 };
 
 }  // namespace NodeStore
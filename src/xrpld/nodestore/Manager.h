@@ -65,6 +65,14 @@ public:
         Scheduler& scheduler,
         beast::Journal journal) = 0;
 
+    /** Create a flat state index for the configured backend type.
+
+        @note An exception is thrown if the backend type does not support
+              a state index.
+    */
+    virtual std::unique_ptr<StateIndex>
+    make_StateIndex(Section const& parameters, beast::Journal journal) = 0;
+
     /** Construct a NodeStore database.
 
         The parameters are key value pairs passed to the backend. The
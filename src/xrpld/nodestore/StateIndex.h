@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_STATEINDEX_H_INCLUDED
+#define RIPPLE_NODESTORE_STATEINDEX_H_INCLUDED
+
+#include <xrpl/basics/Blob.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/protocol/Protocol.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A flat index of ledger state entries, by ledger sequence and key.
+
+    Every version of a state entry is stored under its key and the sequence
+    of the ledger that created or changed it, so the state of any ledger in
+    the indexed range can be read without walking a SHAMap. A deletion is
+    stored as a version with no data.
+
+    The index covers a contiguous range of ledgers. The first ledger of the
+    range is written in full, and each later ledger as the changes from its
+    parent.
+
+    All functions are thread safe.
+*/
+class StateIndex
+{
+public:
+    /** A state entry, or a deletion if the data is empty. */
+    using Entry = std::pair<uint256, Blob>;
+
+    virtual ~StateIndex() = default;
+
+    /** Return the first and last ledger that are fully indexed. */
+    virtual std::optional<std::pair<LedgerIndex, LedgerIndex>>
+    range() = 0;
+
+    /** Remove all entries, leaving an empty index. */
+    virtual void
+    clear() = 0;
+
+    /** Store some of the entries of a ledger.
+
+        The entries are not considered part of the index until the ledger
+        is committed.
+    */
+    virtual void
+    store(LedgerIndex seq, std::vector<Entry> const& entries) = 0;
+
+    /** Mark a ledger as fully stored.
+
+        @param seq The ledger, which must follow the last one in the range
+                   unless it starts a new range.
+        @param first `true` if all of the ledger's state was stored, and the
+                     range starts with it.
+    */
+    virtual void
+    commit(LedgerIndex seq, bool first) = 0;
+
+    /** Drop the versions that are not needed to read ledgers from `seq` on.
+
+        The range then starts with `seq`. Nothing is done if `seq` is not
+        past the first ledger of the range, and `seq` is limited to the last.
+    */
+    virtual void
+    prune(LedgerIndex seq) = 0;
+
+    /** Return the data of a state entry as of a ledger. */
+    virtual std::optional<Blob>
+    fetch(LedgerIndex seq, uint256 const& key) = 0;
+
+    /** Return state entries as of a ledger, in key order.
+
+        @param seq The ledger.
+        @param from The first key to consider.
+        @param limit The most entries to return.
+    */
+    virtual std::vector<Entry>
+    scan(LedgerIndex seq, uint256 const& from, std::size_t limit) = 0;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -22,6 +22,8 @@
 #include <xrpl/basics/contract.h>
 #include <boost/beast/core/string.hpp>
 #include <boost/core/ignore_unused.hpp>
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -59,6 +61,10 @@ public:
         Scheduler& scheduler,
         beast::Journal journal) override;
 
+    std::unique_ptr<StateIndex>
+    createStateIndex(Section const& keyValues, beast::Journal journal)
+        override;
+
     MemoryDB&
     open(std::string const& path)
     {
@@ -212,6 +218,108 @@ public:
 
 //------------------------------------------------------------------------------
 
+class MemoryStateIndex : public StateIndex
+{
+private:
+    // The versions of an entry, newest first
+    using Versions = std::map<LedgerIndex, Blob, std::greater<LedgerIndex>>;
+
+    std::mutex mutex_;
+    std::map<uint256, Versions> table_;
+    std::optional<std::pair<LedgerIndex, LedgerIndex>> range_;
+
+public:
+    std::optional<std::pair<LedgerIndex, LedgerIndex>>
+    range() override
+    {
+        std::lock_guard _(mutex_);
+        return range_;
+    }
+
+    void
+    clear() override
+    {
+        std::lock_guard _(mutex_);
+        table_.clear();
+        range_.reset();
+    }
+
+    void
+    store(LedgerIndex seq, std::vector<Entry> const& entries) override
+    {
+        std::lock_guard _(mutex_);
+        for (auto const& [key, data] : entries)
+            table_[key].insert_or_assign(seq, data);
+    }
+
+    void
+    commit(LedgerIndex seq, bool first) override
+    {
+        std::lock_guard _(mutex_);
+        if (first)
+            range_.emplace(seq, seq);
+        else if (range_ && range_->second + 1 == seq)
+            range_->second = seq;
+        else
+            Throw<std::logic_error>("State index ledger is out of sequence");
+    }
+
+    void
+    prune(LedgerIndex seq) override
+    {
+        std::lock_guard _(mutex_);
+        if (!range_ || seq <= range_->first)
+            return;
+        seq = std::min(seq, range_->second);
+        range_->first = seq;
+
+        for (auto iter = table_.begin(); iter != table_.end();)
+        {
+            auto& versions = iter->second;
+            // Keep the newest version as of seq, unless it is a deletion
+            auto version = versions.lower_bound(seq);
+            if (version != versions.end() && !version->second.empty())
+                ++version;
+            versions.erase(version, versions.end());
+            if (versions.empty())
+                iter = table_.erase(iter);
+            else
+                ++iter;
+        }
+    }
+
+    std::optional<Blob>
+    fetch(LedgerIndex seq, uint256 const& key) override
+    {
+        std::lock_guard _(mutex_);
+        auto const iter = table_.find(key);
+        if (iter == table_.end())
+            return std::nullopt;
+        auto const version = iter->second.lower_bound(seq);
+        if (version == iter->second.end() || version->second.empty())
+            return std::nullopt;
+        return version->second;
+    }
+
+    std::vector<Entry>
+    scan(LedgerIndex seq, uint256 const& from, std::size_t limit) override
+    {
+        std::vector<Entry> result;
+        std::lock_guard _(mutex_);
+        for (auto iter = table_.lower_bound(from);
+             iter != table_.end() && result.size() < limit;
+             ++iter)
+        {
+            auto const version = iter->second.lower_bound(seq);
+            if (version != iter->second.end() && !version->second.empty())
+                result.emplace_back(iter->first, version->second);
+        }
+        return result;
+    }
+};
+
+//------------------------------------------------------------------------------
+
 MemoryFactory::MemoryFactory()
 {
     Manager::instance().insert(*this);
@@ -239,5 +347,11 @@ MemoryFactory::createInstance(
     return std::make_unique<MemoryBackend>(keyBytes, keyValues, journal);
 }
 
+std::unique_ptr<StateIndex>
+MemoryFactory::createStateIndex(Section const&, beast::Journal)
+{
+    return std::make_unique<MemoryStateIndex>();
+}
+
 }  // namespace NodeStore
 }  // namespace ripple
@@ -23,14 +23,19 @@
 #include <xrpld/nodestore/detail/EncodedBlob.h>
 #include <xrpld/nodestore/detail/codec.h>
 #include <xrpl/basics/contract.h>
+#include <xrpl/beast/core/CurrentThreadName.h>
 #include <boost/filesystem.hpp>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <deque>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <nudb/nudb.hpp>
+#include <thread>
 
 namespace ripple {
 namespace NodeStore {
@@ -44,6 +49,9 @@ public:
     /* "SHRD" in ASCII */
     static constexpr std::uint64_t deterministicType = 0x5348524400000000ull;
 
+    // Batches smaller than this are fetched serially on the calling thread.
+    static constexpr std::size_t minParallelBatch = 8;
+
     beast::Journal const j_;
     size_t const keyBytes_;
     std::size_t const burstSize_;
@@ -52,6 +60,38 @@ public:
     std::atomic<bool> deletePath_;
     Scheduler& scheduler_;
 
+    /** A batch of keys being fetched concurrently.
+
+        The calling thread and every reader thread claim keys by
+        incrementing `next` until the batch is exhausted, so the reads
+        of a batch are in flight on the device at the same time.
+    */
+    struct BatchRead
+    {
+        std::vector<uint256 const*> const& hashes;
+        std::size_t const size;
+        std::vector<std::shared_ptr<NodeObject>> results;
+        std::atomic<std::size_t> next{0};
+        std::size_t remaining;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+
+        explicit BatchRead(std::vector<uint256 const*> const& h)
+            : hashes(h), size(h.size()), results(size), remaining(size)
+        {
+        }
+    };
+
+    // Number of reader threads servicing fetchBatch, 0 to disable.
+    std::size_t const batchThreads_;
+    std::once_flag readersStarted_;
+    std::vector<std::thread> readers_;
+    std::mutex readMutex_;
+    std::condition_variable readCond_;
+    std::deque<std::shared_ptr<BatchRead>> readQueue_;
+    bool readStop_ = false;
+
     NuDBBackend(
         size_t keyBytes,
         Section const& keyValues,
@@ -64,6 +104,7 @@ public:
         , name_(get(keyValues, "path"))
         , deletePath_(false)
         , scheduler_(scheduler)
+        , batchThreads_(get<std::size_t>(keyValues, "batch_threads", 4))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -84,6 +125,7 @@ public:
         , db_(context)
         , deletePath_(false)
         , scheduler_(scheduler)
+        , batchThreads_(get<std::size_t>(keyValues, "batch_threads", 4))
     {
         if (name_.empty())
             Throw<std::runtime_error>(
@@ -92,6 +134,14 @@ public:
 
     ~NuDBBackend() override
     {
+        {
+            std::lock_guard lock(readMutex_);
+            readStop_ = true;
+        }
+        readCond_.notify_all();
+        for (auto& t : readers_)
+            t.join();
+
         try
         {
             // close can throw and we don't want the destructor to throw.
@@ -210,16 +260,8 @@ public:
         db_.fetch(
             key,
             [key, pno, &status](void const* data, std::size_t size) {
-                nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
-                DecodedBlob decoded(key, result.first, result.second);
-                if (!decoded.wasOk())
-                {
-                    status = dataCorrupt;
-                    return;
-                }
-                *pno = decoded.createObject();
-                status = ok;
+                *pno = nodeobject_decode(key, data, size);
+                status = *pno ? ok : dataCorrupt;
             },
             ec);
         if (ec == nudb::error::key_not_found)
@@ -232,19 +274,106 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
-        std::vector<std::shared_ptr<NodeObject>> results;
-        results.reserve(hashes.size());
-        for (auto const& h : hashes)
+        if (batchThreads_ == 0 || hashes.size() < minParallelBatch)
+        {
+            std::vector<std::shared_ptr<NodeObject>> results;
+            results.reserve(hashes.size());
+            for (auto const& h : hashes)
+            {
+                std::shared_ptr<NodeObject> nObj;
+                Status status = fetch(h->begin(), &nObj);
+                if (status != ok)
+                    results.push_back({});
+                else
+                    results.push_back(nObj);
+            }
+
+            return {results, ok};
+        }
+
+        std::call_once(readersStarted_, [this]() {
+            readers_.reserve(batchThreads_);
+            for (std::size_t i = 0; i < batchThreads_; ++i)
+                readers_.emplace_back([this, i]() { doReads(i); });
+        });
+
+        auto batch = std::make_shared<BatchRead>(hashes);
+        {
+            std::lock_guard lock(readMutex_);
+            readQueue_.push_back(batch);
+        }
+        readCond_.notify_all();
+
+        // The calling thread takes part in the batch too, so a busy reader
+        // pool can never leave it waiting on work nobody has claimed.
+        readBatch(*batch);
+
+        std::unique_lock lock(batch->mutex);
+        batch->done.wait(lock, [&batch]() { return batch->remaining == 0; });
+        if (batch->error)
+            std::rethrow_exception(batch->error);
+
+        return {std::move(batch->results), ok};
+    }
+
+    // Claim and fetch keys from the batch until none are left
+    void
+    readBatch(BatchRead& batch)
+    {
+        std::size_t n = 0;
+        std::exception_ptr error;
+        for (auto i = batch.next++; i < batch.size; i = batch.next++)
         {
-            std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+            try
+            {
+                std::shared_ptr<NodeObject> nObj;
+                if (fetch(batch.hashes[i]->begin(), &nObj) == ok)
+                    batch.results[i] = std::move(nObj);
+            }
+            catch (std::exception const&)
+            {
+                error = std::current_exception();
+            }
+            ++n;
         }
 
-        return {results, ok};
+        if (n == 0)
+            return;
+
+        std::lock_guard lock(batch.mutex);
+        if (error && !batch.error)
+            batch.error = error;
+        batch.remaining -= n;
+        if (batch.remaining == 0)
+            batch.done.notify_all();
+    }
+
+    void
+    doReads(std::size_t id)
+    {
+        beast::setCurrentThreadName("nudb read #" + std::to_string(id));
+
+        std::unique_lock lock(readMutex_);
+        while (true)
+        {
+            readCond_.wait(
+                lock, [this]() { return readStop_ || !readQueue_.empty(); });
+            if (readStop_)
+                return;
+
+            auto batch = readQueue_.front();
+            if (batch->next >= batch->size)
+            {
+                // Every key has been claimed; the remaining reads are in
+                // progress on other threads.
+                readQueue_.pop_front();
+                continue;
+            }
+
+            lock.unlock();
+            readBatch(*batch);
+            lock.lock();
+        }
     }
 
     void
@@ -307,15 +436,13 @@ public:
                 void const* data,
                 std::size_t size,
                 nudb::error_code&) {
-                nudb::detail::buffer bf;
-                auto const result = nodeobject_decompress(data, size, bf);
-                DecodedBlob decoded(key, result.first, result.second);
-                if (!decoded.wasOk())
+                auto object = nodeobject_decode(key, data, size);
+                if (!object)
                 {
                     ec = make_error_code(nudb::error::missing_value);
                     return;
                 }
-                f(decoded.createObject());
+                f(std::move(object));
             },
             nudb::no_progress{},
             ec);
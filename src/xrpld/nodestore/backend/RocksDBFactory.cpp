@@ -32,8 +32,14 @@
 #include <xrpl/basics/safe_cast.h>
 #include <xrpl/beast/core/CurrentThreadName.h>
 
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstring>
 #include <memory>
+#include <shared_mutex>
 
 namespace ripple {
 namespace NodeStore {
@@ -281,13 +287,16 @@ public:
         rocksdb::ReadOptions const options;
         rocksdb::Slice const slice(static_cast<char const*>(key), m_keyBytes);
 
-        std::string string;
+        // The value is decoded from the block cache when it is pinned there,
+        // rather than being copied out first.
+        rocksdb::PinnableSlice value;
 
-        rocksdb::Status getStatus = m_db->Get(options, slice, &string);
+        rocksdb::Status getStatus =
+            m_db->Get(options, m_db->DefaultColumnFamily(), slice, &value);
 
         if (getStatus.ok())
         {
-            DecodedBlob decoded(key, string.data(), string.size());
+            DecodedBlob decoded(key, value.data(), value.size());
 
             if (decoded.wasOk())
             {
@@ -325,16 +334,50 @@ public:
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
-        std::vector<std::shared_ptr<NodeObject>> results;
-        results.reserve(hashes.size());
+        assert(m_db);
+        std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+        if (hashes.empty())
+            return {results, ok};
+
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
         for (auto const& h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        // A single MultiGet lets RocksDB look up every key in the batch
+        // together, coalescing block reads and issuing them in parallel
+        // rather than paying one synchronous read per key.
+        std::vector<rocksdb::PinnableSlice> values(hashes.size());
+        std::vector<rocksdb::Status> statuses(hashes.size());
+        rocksdb::ReadOptions const options;
+        m_db->MultiGet(
+            options,
+            m_db->DefaultColumnFamily(),
+            keys.size(),
+            keys.data(),
+            values.data(),
+            statuses.data());
+
+        for (std::size_t i = 0; i < hashes.size(); ++i)
         {
-            std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+            auto const& getStatus = statuses[i];
+            if (getStatus.ok())
+            {
+                DecodedBlob decoded(
+                    hashes[i]->data(), values[i].data(), values[i].size());
+
+                if (decoded.wasOk())
+                    results[i] = decoded.createObject();
+                else
+                    JLOG(m_journal.error())
+                        << "fetchBatch " << *hashes[i] << ": corrupt data";
+            }
+            else if (!getStatus.IsNotFound())
+            {
+                JLOG(m_journal.error()) << "fetchBatch " << *hashes[i] << ": "
+                                        << getStatus.ToString();
+            }
         }
 
         return {results, ok};
@@ -444,6 +487,324 @@ public:
 
 //------------------------------------------------------------------------------
 
+class RocksDBStateIndex : public StateIndex
+{
+private:
+    // Versions are keyed by the entry's key followed by the complement of
+    // the ledger sequence, so the newest version of each entry comes first.
+    static constexpr std::size_t versionKeyBytes = uint256::bytes + 4;
+    using VersionKey = std::array<char, versionKeyBytes>;
+
+    static VersionKey
+    makeKey(uint256 const& key, LedgerIndex seq)
+    {
+        VersionKey result;
+        std::memcpy(result.data(), key.data(), uint256::bytes);
+        auto const inverse = ~seq;
+        for (int i = 0; i < 4; ++i)
+            result[uint256::bytes + i] =
+                static_cast<char>((inverse >> (24 - 8 * i)) & 0xff);
+        return result;
+    }
+
+    static std::pair<uint256, LedgerIndex>
+    parseKey(rocksdb::Slice const& slice)
+    {
+        assert(slice.size() == versionKeyBytes);
+        auto const p = reinterpret_cast<std::uint8_t const*>(slice.data());
+        LedgerIndex inverse = 0;
+        for (int i = 0; i < 4; ++i)
+            inverse = (inverse << 8) | p[uint256::bytes + i];
+        return {uint256::fromVoid(p), ~inverse};
+    }
+
+    static rocksdb::Slice
+    toSlice(VersionKey const& key)
+    {
+        return {key.data(), key.size()};
+    }
+
+    static constexpr char rangeKey[] = "range";
+
+    // The most deletions written at once while pruning
+    static constexpr int pruneBatchSize = 4096;
+
+    beast::Journal const j_;
+    rocksdb::ColumnFamilyOptions stateOptions_;
+    std::unique_ptr<rocksdb::DB> db_;
+    rocksdb::ColumnFamilyHandle* default_ = nullptr;
+    rocksdb::ColumnFamilyHandle* state_ = nullptr;
+
+    // Writers of the range, and clear(), hold this exclusively
+    std::shared_mutex mutable mutex_;
+    std::optional<std::pair<LedgerIndex, LedgerIndex>> range_;
+
+    void
+    check(rocksdb::Status const& status, char const* what)
+    {
+        if (!status.ok())
+            Throw<std::runtime_error>(
+                std::string("RocksDB state index ") + what + " failed: " +
+                status.ToString());
+    }
+
+    // The range is stored as the big endian first and last ledger
+    void
+    saveRange(
+        std::pair<LedgerIndex, LedgerIndex> const& range,
+        char const* what)
+    {
+        std::array<char, 8> value;
+        for (int i = 0; i < 4; ++i)
+        {
+            value[i] = static_cast<char>((range.first >> (24 - 8 * i)) & 0xff);
+            value[4 + i] =
+                static_cast<char>((range.second >> (24 - 8 * i)) & 0xff);
+        }
+        check(
+            db_->Put(
+                rocksdb::WriteOptions(),
+                default_,
+                rangeKey,
+                rocksdb::Slice(value.data(), value.size())),
+            what);
+    }
+
+public:
+    RocksDBStateIndex(Section const& keyValues, beast::Journal journal)
+        : j_(journal)
+    {
+        std::string base;
+        if (!get_if_exists(keyValues, "path", base))
+            Throw<std::runtime_error>("Missing path in RocksDBFactory backend");
+        auto const path = boost::filesystem::path(base) / "state_index";
+        boost::filesystem::create_directories(path);
+
+        rocksdb::BlockBasedTableOptions table_options;
+        if (keyValues.exists("cache_mb"))
+            table_options.block_cache = rocksdb::NewLRUCache(
+                megabytes(get<int>(keyValues, "cache_mb")));
+        table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
+        stateOptions_.table_factory.reset(
+            rocksdb::NewBlockBasedTableFactory(table_options));
+        stateOptions_.compression = rocksdb::kSnappyCompression;
+
+        rocksdb::DBOptions options;
+        options.create_if_missing = true;
+        options.create_missing_column_families = true;
+
+        std::vector<rocksdb::ColumnFamilyDescriptor> const families{
+            {rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions{}},
+            {"state", stateOptions_}};
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
+        rocksdb::DB* db = nullptr;
+        auto const status =
+            rocksdb::DB::Open(options, path.string(), families, &handles, &db);
+        if (!status.ok() || !db)
+            Throw<std::runtime_error>(
+                std::string("Unable to open/create RocksDB state index: ") +
+                status.ToString());
+        db_.reset(db);
+        default_ = handles[0];
+        state_ = handles[1];
+
+        std::string value;
+        auto const found =
+            db_->Get(rocksdb::ReadOptions(), default_, rangeKey, &value);
+        if (found.ok() && value.size() == 8)
+        {
+            auto const p = reinterpret_cast<std::uint8_t const*>(value.data());
+            auto const get32 = [p](int offset) {
+                return (LedgerIndex(p[offset]) << 24) |
+                    (LedgerIndex(p[offset + 1]) << 16) |
+                    (LedgerIndex(p[offset + 2]) << 8) | p[offset + 3];
+            };
+            range_.emplace(get32(0), get32(4));
+            JLOG(j_.info()) << "State index covers ledgers " << range_->first
+                            << " to " << range_->second;
+        }
+    }
+
+    ~RocksDBStateIndex() override
+    {
+        if (state_)
+            db_->DestroyColumnFamilyHandle(state_);
+        db_->DestroyColumnFamilyHandle(default_);
+    }
+
+    std::optional<std::pair<LedgerIndex, LedgerIndex>>
+    range() override
+    {
+        std::shared_lock sl(mutex_);
+        return range_;
+    }
+
+    void
+    clear() override
+    {
+        std::unique_lock sl(mutex_);
+        check(
+            db_->Delete(rocksdb::WriteOptions(), default_, rangeKey),
+            "delete");
+        range_.reset();
+        check(db_->DropColumnFamily(state_), "drop");
+        check(db_->DestroyColumnFamilyHandle(state_), "drop");
+        state_ = nullptr;
+        check(
+            db_->CreateColumnFamily(stateOptions_, "state", &state_),
+            "clear");
+    }
+
+    void
+    store(LedgerIndex seq, std::vector<Entry> const& entries) override
+    {
+        std::shared_lock sl(mutex_);
+        rocksdb::WriteBatch wb;
+        for (auto const& [key, data] : entries)
+        {
+            auto const k = makeKey(key, seq);
+            wb.Put(
+                state_,
+                toSlice(k),
+                rocksdb::Slice(
+                    reinterpret_cast<char const*>(data.data()), data.size()));
+        }
+        check(db_->Write(rocksdb::WriteOptions(), &wb), "store");
+    }
+
+    void
+    commit(LedgerIndex seq, bool first) override
+    {
+        std::unique_lock sl(mutex_);
+        std::pair<LedgerIndex, LedgerIndex> range{seq, seq};
+        if (!first)
+        {
+            if (!range_ || range_->second + 1 != seq)
+                Throw<std::logic_error>(
+                    "State index ledger is out of sequence");
+            range.first = range_->first;
+        }
+
+        saveRange(range, "commit");
+        range_ = range;
+    }
+
+    void
+    prune(LedgerIndex seq) override
+    {
+        {
+            std::unique_lock sl(mutex_);
+            if (!range_ || seq <= range_->first)
+                return;
+            seq = std::min(seq, range_->second);
+            std::pair<LedgerIndex, LedgerIndex> const range{
+                seq, range_->second};
+            saveRange(range, "prune");
+            range_ = range;
+        }
+
+        // Readers may use the index while the old versions are deleted
+        std::shared_lock sl(mutex_);
+        if (!range_ || range_->first != seq)
+            return;
+
+        std::unique_ptr<rocksdb::Iterator> it(
+            db_->NewIterator(rocksdb::ReadOptions{}, state_));
+        rocksdb::WriteBatch wb;
+        std::size_t deleted = 0;
+        std::optional<uint256> current;
+        bool kept = false;
+        for (it->SeekToFirst(); it->Valid(); it->Next())
+        {
+            auto const [key, version] = parseKey(it->key());
+            if (key != current)
+            {
+                current = key;
+                kept = false;
+            }
+            if (version > seq)
+                continue;
+
+            // Keep the newest version as of seq, unless it is a deletion
+            if (!kept)
+            {
+                kept = true;
+                if (!it->value().empty())
+                    continue;
+            }
+            wb.Delete(state_, it->key());
+            if (wb.Count() >= pruneBatchSize)
+            {
+                check(db_->Write(rocksdb::WriteOptions(), &wb), "prune");
+                deleted += wb.Count();
+                wb.Clear();
+            }
+        }
+        check(it->status(), "prune");
+        check(db_->Write(rocksdb::WriteOptions(), &wb), "prune");
+        deleted += wb.Count();
+        JLOG(j_.debug()) << "State index pruned " << deleted
+                         << " versions before ledger " << seq;
+    }
+
+    std::optional<Blob>
+    fetch(LedgerIndex seq, uint256 const& key) override
+    {
+        std::shared_lock sl(mutex_);
+        std::unique_ptr<rocksdb::Iterator> it(
+            db_->NewIterator(rocksdb::ReadOptions{}, state_));
+        it->Seek(toSlice(makeKey(key, seq)));
+        if (!it->Valid())
+        {
+            check(it->status(), "fetch");
+            return std::nullopt;
+        }
+        if (parseKey(it->key()).first != key || it->value().empty())
+            return std::nullopt;
+        auto const value = it->value();
+        auto const p = reinterpret_cast<std::uint8_t const*>(value.data());
+        return Blob(p, p + value.size());
+    }
+
+    std::vector<Entry>
+    scan(LedgerIndex seq, uint256 const& from, std::size_t limit) override
+    {
+        std::vector<Entry> result;
+        std::shared_lock sl(mutex_);
+        std::unique_ptr<rocksdb::Iterator> it(
+            db_->NewIterator(rocksdb::ReadOptions{}, state_));
+
+        // Each seek lands on the newest version of an entry that is not newer
+        // than the ledger, or on a newer version of the next entry.
+        it->Seek(toSlice(makeKey(from, seq)));
+        while (it->Valid() && result.size() < limit)
+        {
+            auto [key, version] = parseKey(it->key());
+            if (version > seq)
+            {
+                it->Seek(toSlice(makeKey(key, seq)));
+                continue;
+            }
+
+            if (auto const value = it->value(); !value.empty())
+            {
+                auto const p =
+                    reinterpret_cast<std::uint8_t const*>(value.data());
+                result.emplace_back(key, Blob(p, p + value.size()));
+            }
+
+            // Skip the older versions of this entry
+            if (++key == beast::zero)
+                break;
+            it->Seek(toSlice(makeKey(key, seq)));
+        }
+        check(it->status(), "scan");
+        return result;
+    }
+};
+
+//------------------------------------------------------------------------------
+
 class RocksDBFactory : public Factory
 {
 public:
@@ -476,6 +837,13 @@ public:
         return std::make_unique<RocksDBBackend>(
             keyBytes, keyValues, scheduler, journal, &m_env);
     }
+
+    std::unique_ptr<StateIndex>
+    createStateIndex(Section const& keyValues, beast::Journal journal)
+        override
+    {
+        return std::make_unique<RocksDBStateIndex>(keyValues, journal);
+    }
 };
 
 static RocksDBFactory rocksDBFactory;
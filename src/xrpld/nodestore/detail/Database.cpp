@@ -275,6 +275,16 @@ Database::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatch(std::vector<uint256> const& hashes)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+    for (auto const& hash : hashes)
+        results.push_back(fetchNodeObject(hash));
+    return results;
+}
+
 bool
 Database::storeLedger(
     Ledger const& srcLedger,
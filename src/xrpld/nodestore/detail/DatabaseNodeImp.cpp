@@ -192,7 +192,7 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
         else
         {
-            JLOG(j_.error())
+            JLOG(j_.debug())
                 << "fetchBatch - "
                 << "record not found in db or cache. hash = " << strHex(hash);
             if (cache_)
@@ -87,5 +87,24 @@ DecodedBlob::createObject()
     return object;
 }
 
+std::shared_ptr<NodeObject>
+DecodedBlob::createObject(Blob&& value)
+{
+    assert(m_success);
+    assert(m_objectData == value.data() + 9);
+
+    std::shared_ptr<NodeObject> object;
+
+    if (m_success)
+    {
+        value.erase(value.begin(), value.begin() + 9);
+
+        object = NodeObject::createObject(
+            m_objectType, std::move(value), uint256::fromVoid(m_key));
+    }
+
+    return object;
+}
+
 }  // namespace NodeStore
 }  // namespace ripple
@@ -52,6 +52,14 @@ public:
     std::shared_ptr<NodeObject>
     createObject();
 
+    /** Create a NodeObject from this data, reusing its buffer.
+
+        @param value The buffer the blob was decoded from. Its header is
+                     removed in place and the object takes it over.
+    */
+    std::shared_ptr<NodeObject>
+    createObject(Blob&& value);
+
 private:
     bool m_success;
 
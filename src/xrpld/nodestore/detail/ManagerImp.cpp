@@ -68,6 +68,24 @@ ManagerImp::make_Backend(
         NodeObject::keyBytes, parameters, burstSize, scheduler, journal);
 }
 
+std::unique_ptr<StateIndex>
+ManagerImp::make_StateIndex(Section const& parameters, beast::Journal journal)
+{
+    std::string const type{get(parameters, "type")};
+    if (type.empty())
+        missing_backend();
+
+    auto factory{find(type)};
+    if (!factory)
+        missing_backend();
+
+    auto index = factory->createStateIndex(parameters, journal);
+    if (!index)
+        Throw<std::runtime_error>(
+            "The " + type + " node store does not support a state index");
+    return index;
+}
+
 std::unique_ptr<Database>
 ManagerImp::make_Database(
     std::size_t burstSize,
@@ -59,6 +59,10 @@ public:
         Scheduler& scheduler,
         beast::Journal journal) override;
 
+    std::unique_ptr<StateIndex>
+    make_StateIndex(Section const& parameters, beast::Journal journal)
+        override;
+
     std::unique_ptr<Database>
     make_Database(
         std::size_t burstSize,
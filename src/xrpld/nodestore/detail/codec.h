@@ -24,10 +24,12 @@
 #define LZ4_DISABLE_DEPRECATE_WARNINGS
 
 #include <xrpld/nodestore/NodeObject.h>
+#include <xrpld/nodestore/detail/DecodedBlob.h>
 #include <xrpld/nodestore/detail/varint.h>
 #include <xrpl/basics/contract.h>
 #include <xrpl/basics/safe_cast.h>
 #include <xrpl/protocol/HashPrefix.h>
+#include <bitset>
 #include <cstddef>
 #include <cstring>
 #include <lz4.h>
@@ -206,6 +208,101 @@ nodeobject_decompress(void const* in, std::size_t in_size, BufferFactory&& bf)
     return result;
 }
 
+/** Decode a stored value straight into a NodeObject.
+
+    This gives the same object as nodeobject_decompress followed by
+    DecodedBlob, without the intermediate buffer: inner nodes are expanded
+    directly into the object's data, and lz4 data is decompressed into the
+    buffer the object keeps.
+
+    @return The object, or nullptr if the decoded data is not valid.
+*/
+template <class = void>
+std::shared_ptr<NodeObject>
+nodeobject_decode(void const* key, void const* in, std::size_t in_size)
+{
+    using namespace nudb::detail;
+
+    std::uint8_t const* p = reinterpret_cast<std::uint8_t const*>(in);
+    std::size_t type;
+    auto const vn = read_varint(p, in_size, type);
+    if (vn == 0)
+        Throw<std::runtime_error>("nodeobject decode");
+    p += vn;
+    in_size -= vn;
+
+    switch (type)
+    {
+        case 0:  // uncompressed
+        {
+            DecodedBlob decoded(key, p, in_size);
+            if (!decoded.wasOk())
+                return {};
+            return decoded.createObject();
+        }
+        case 1:  // lz4
+        {
+            Blob data;
+            lz4_decompress(p, in_size, [&data](std::size_t n) {
+                data.resize(n);
+                return data.data();
+            });
+            DecodedBlob decoded(key, data.data(), data.size());
+            if (!decoded.wasOk())
+                return {};
+            return decoded.createObject(std::move(data));
+        }
+        case 2:  // compressed v1 inner node
+        case 3:  // full v1 inner node
+        {
+            std::uint16_t mask = 0xffff;
+            if (type == 2)
+            {
+                auto const hs = field<std::uint16_t>::size;
+                if (in_size < hs)
+                    Throw<std::runtime_error>(
+                        "nodeobject codec v1: short inner node size: " +
+                        std::string("in_size = ") + std::to_string(in_size));
+                istream is(p, in_size);
+                read<std::uint16_t>(is, mask);
+                p += hs;
+                in_size -= hs;
+                if (mask == 0)
+                    Throw<std::runtime_error>(
+                        "nodeobject codec v1: empty inner node");
+            }
+
+            std::size_t const hashes = std::bitset<16>(mask).count();
+            if (in_size != hashes * 32)
+                Throw<std::runtime_error>(
+                    "nodeobject codec v1: bad inner node size, in_size = " +
+                    std::to_string(in_size));
+
+            // The hash prefix and the sixteen child hashes
+            Blob data(4 + 16 * 32);
+            ostream os(data.data(), data.size());
+            write<std::uint32_t>(
+                os, static_cast<std::uint32_t>(HashPrefix::innerNode));
+            std::uint16_t bit = 0x8000;
+            for (int i = 16; i--; bit >>= 1)
+            {
+                auto const out = os.data(32);
+                if (mask & bit)
+                {
+                    std::memcpy(out, p, 32);
+                    p += 32;
+                }
+            }
+            return NodeObject::createObject(
+                hotUNKNOWN, std::move(data), uint256::fromVoid(key));
+        }
+        default:
+            Throw<std::runtime_error>(
+                "nodeobject codec: bad type=" + std::to_string(type));
+    };
+    return {};
+}
+
 template <class = void>
 void const*
 zero32()
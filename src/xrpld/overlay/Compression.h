@@ -37,6 +37,17 @@ enum class Algorithm : std::uint8_t { None = 0x00, LZ4 = 0x90 };
 
 enum class Compressed : std::uint8_t { On, Off };
 
+/** How hard to try to compress a message.
+
+    High effort uses the LZ4HC compressor, which is several times slower
+    than the default LZ4 compressor but produces the same block format, so
+    any peer that accepts LZ4 can decompress it.
+*/
+enum class Effort : std::uint8_t { Fast, High };
+
+/** The LZ4HC level used for high effort compression. */
+int constexpr highEffortLevel = LZ4HC_CLEVEL_DEFAULT;
+
 /** Decompress input stream.
  * @tparam InputStream ZeroCopyInputStream
  * @param in Input source stream
@@ -80,6 +91,7 @@ decompress(
  * @param inSize Size of the data
  * @param bf Compressed buffer allocator
  * @param algorithm Compression algorithm type
+ * @param effort How hard to try
  * @return Size of compressed data, or zero if failed to compress
  */
 template <class BufferFactory>
@@ -88,13 +100,17 @@ compress(
     void const* in,
     std::size_t inSize,
     BufferFactory&& bf,
-    Algorithm algorithm = Algorithm::LZ4)
+    Algorithm algorithm = Algorithm::LZ4,
+    Effort effort = Effort::Fast)
 {
     try
     {
         if (algorithm == Algorithm::LZ4)
             return ripple::compression_algorithms::lz4Compress(
-                in, inSize, std::forward<BufferFactory>(bf));
+                in,
+                inSize,
+                std::forward<BufferFactory>(bf),
+                effort == Effort::High ? highEffortLevel : 0);
         else
         {
             JLOG(debugLog().warn()) << "compress: invalid compression algorithm"
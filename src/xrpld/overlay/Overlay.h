@@ -74,6 +74,8 @@ public:
         std::uint32_t crawlOptions = 0;
         std::optional<std::uint32_t> networkID;
         bool vlEnabled = true;
+        std::chrono::milliseconds txVerifyWindow{0};
+        std::size_t txVerifyJobs = 0;
     };
 
     using PeerSequence = std::vector<std::shared_ptr<Peer>>;
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xrpld/app/ledger/LedgerMaster.h>
+#include <xrpld/app/main/Application.h>
+#include <xrpld/app/misc/HashRouter.h>
+#include <xrpld/app/tx/apply.h>
+#include <xrpld/core/JobQueue.h>
+#include <xrpld/overlay/detail/BatchVerifier.h>
+
+#include <algorithm>
+
+namespace ripple {
+
+BatchVerifier::BatchVerifier(
+    Application& app,
+    boost::asio::io_service& io_service,
+    std::chrono::milliseconds window,
+    std::size_t maxJobs)
+    : app_(app)
+    , window_(window)
+    , maxJobs_(maxJobs ? maxJobs : JobQueue::defaultWorkers())
+    , timer_(io_service)
+{
+}
+
+bool
+BatchVerifier::add(std::shared_ptr<STTx const> const& tx, Continuation&& next)
+{
+    std::lock_guard lock(mutex_);
+
+    if (stopping_ || !enabled())
+        return false;
+
+    pending_.push_back({tx, std::move(next)});
+    ++size_;
+
+    if (pending_.size() >= maxBatchSize)
+    {
+        close(lock);
+    }
+    else if (!timerSet_)
+    {
+        timerSet_ = true;
+        timer_.expires_after(window_);
+        timer_.async_wait([weak = weak_from_this()](
+                              boost::system::error_code const& ec) {
+            if (auto self = weak.lock())
+                self->onTimer(ec);
+        });
+    }
+
+    return true;
+}
+
+void
+BatchVerifier::stop()
+{
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+    timer_.cancel();
+
+    std::size_t dropped = pending_.size();
+    for (auto const& batch : ready_)
+        dropped += batch.size();
+    size_ -= dropped;
+
+    pending_.clear();
+    ready_.clear();
+}
+
+void
+BatchVerifier::onTimer(boost::system::error_code const& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    std::lock_guard lock(mutex_);
+    timerSet_ = false;
+    close(lock);
+}
+
+void
+BatchVerifier::close(std::lock_guard<std::mutex> const&)
+{
+    if (pending_.empty() || stopping_)
+        return;
+
+    // A full batch may be closed before the window expires. A later
+    // expiry then closes whatever has been collected since, which is
+    // harmless.
+    Batch batch;
+    batch.reserve(maxBatchSize);
+    batch.swap(pending_);
+
+    if (jobs_ >= maxJobs_)
+    {
+        ready_.push_back(std::move(batch));
+        return;
+    }
+
+    auto const n = batch.size();
+    ++jobs_;
+    if (!app_.getJobQueue().addJob(
+            jtTRANSACTION,
+            "batchVerify",
+            [self = shared_from_this(), batch = std::move(batch)]() mutable {
+                self->run(std::move(batch));
+            }))
+    {
+        // The job queue is stopping
+        --jobs_;
+        size_ -= n;
+    }
+}
+
+void
+BatchVerifier::run(Batch batch)
+{
+    std::vector<std::shared_ptr<STTx const>> txs;
+    txs.reserve(maxBatchSize);
+
+    for (;;)
+    {
+        txs.clear();
+        for (auto const& item : batch)
+            txs.push_back(item.tx);
+
+        checkSignatures(
+            app_.getHashRouter(),
+            txs,
+            app_.getLedgerMaster().getValidatedRules());
+        size_ -= batch.size();
+
+        for (auto& item : batch)
+            item.next();
+
+        std::lock_guard lock(mutex_);
+        if (ready_.empty())
+        {
+            --jobs_;
+            return;
+        }
+        batch = std::move(ready_.front());
+        ready_.pop_front();
+    }
+}
+
+}  // namespace ripple
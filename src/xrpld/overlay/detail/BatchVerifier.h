@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_BATCHVERIFIER_H_INCLUDED
+#define RIPPLE_OVERLAY_BATCHVERIFIER_H_INCLUDED
+
+#include <xrpl/protocol/STTx.h>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+class Application;
+
+/** Checks the signatures of transactions relayed by peers in batches.
+
+    Transactions that arrive within a short window are collected into a
+    batch, and the batches are checked by a bounded number of jobs. When
+    more batches are ready than there are jobs to check them, they wait,
+    so a flood of transactions cannot occupy more than that number of job
+    threads with signature checking. The result of each check is cached
+    in the HashRouter, where checkValidity finds it, and then the
+    transaction's continuation is called.
+
+    The timer and the jobs hold on to the verifier, so it must be owned by
+    a shared_ptr.
+*/
+class BatchVerifier : public std::enable_shared_from_this<BatchVerifier>
+{
+public:
+    using Continuation = std::function<void()>;
+
+    /** The most transactions checked by a single batch. */
+    static constexpr std::size_t maxBatchSize = 128;
+
+    /** Create a verifier.
+
+        @param window How long to collect transactions before checking
+            them. Zero disables batching.
+        @param maxJobs The most jobs checking batches at once. Zero picks
+            a value from the number of hardware threads.
+    */
+    BatchVerifier(
+        Application& app,
+        boost::asio::io_service& io_service,
+        std::chrono::milliseconds window,
+        std::size_t maxJobs);
+
+    BatchVerifier(BatchVerifier const&) = delete;
+    BatchVerifier&
+    operator=(BatchVerifier const&) = delete;
+
+    bool
+    enabled() const
+    {
+        return window_.count() > 0;
+    }
+
+    /** Queue a transaction for signature checking.
+
+        @param next Called from a job once the signature state of the
+            transaction is cached.
+
+        @return false if the transaction was not queued.
+    */
+    bool
+    add(std::shared_ptr<STTx const> const& tx, Continuation&& next);
+
+    /** The number of transactions waiting to be checked. */
+    std::size_t
+    size() const
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    /** Stop accepting transactions and drop those waiting. */
+    void
+    stop();
+
+private:
+    struct Item
+    {
+        std::shared_ptr<STTx const> tx;
+        Continuation next;
+    };
+
+    using Batch = std::vector<Item>;
+
+    Application& app_;
+    std::chrono::milliseconds const window_;
+    std::size_t const maxJobs_;
+
+    std::mutex mutex_;
+    boost::asio::steady_timer timer_;
+    bool timerSet_ = false;
+    bool stopping_ = false;
+
+    // The batch collecting transactions
+    Batch pending_;
+
+    // Batches waiting for a job
+    std::deque<Batch> ready_;
+
+    // The number of jobs checking batches
+    std::size_t jobs_ = 0;
+
+    // The number of transactions in pending_, ready_ and running jobs
+    std::atomic<std::size_t> size_{0};
+
+    void
+    onTimer(boost::system::error_code const& ec);
+
+    // Closes the pending batch and hands it to a job, if one is free.
+    void
+    close(std::lock_guard<std::mutex> const&);
+
+    // Checks batches until none are waiting.
+    void
+    run(Batch batch);
+};
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_OVERLAY_LATENCYHISTOGRAM_H_INCLUDED
+#define RIPPLE_OVERLAY_LATENCYHISTOGRAM_H_INCLUDED
+
+#include <xrpl/json/json_value.h>
+#include <xrpl/protocol/jss.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ripple {
+
+/** A histogram of durations that can be updated from any thread.
+
+    Samples are counted in buckets bounded by powers of two, so percentiles
+    are accurate to within a factor of two. That is enough to tell a slow
+    peer from a fast one, for a couple of atomic increments per sample.
+*/
+template <class Duration>
+class LatencyHistogram
+{
+public:
+    using duration = Duration;
+
+    void
+    add(Duration d)
+    {
+        auto const v = d.count() > 0 ? static_cast<std::uint64_t>(d.count())
+                                     : std::uint64_t{0};
+        counts_[std::bit_width(v)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(v, std::memory_order_relaxed);
+
+        auto m = max_.load(std::memory_order_relaxed);
+        while (v > m &&
+               !max_.compare_exchange_weak(m, v, std::memory_order_relaxed))
+            ;
+    }
+
+    /** Return the number of samples. */
+    std::uint64_t
+    count() const
+    {
+        std::uint64_t n = 0;
+        for (auto const& c : counts_)
+            n += c.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    /** Return the sum of all samples. */
+    Duration
+    total() const
+    {
+        return Duration{total_.load(std::memory_order_relaxed)};
+    }
+
+    /** Return the longest sample. */
+    Duration
+    max() const
+    {
+        return Duration{max_.load(std::memory_order_relaxed)};
+    }
+
+    /** Return an upper bound of the given percentile of the samples.
+
+        @param pct The percentile, from 0 to 100.
+    */
+    Duration
+    percentile(std::uint32_t pct) const
+    {
+        auto const n = count();
+        if (n == 0)
+            return Duration{0};
+
+        // The rank of the sample, rounded up
+        auto const rank = (n * pct + 99) / 100;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+        {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank && seen != 0)
+            {
+                // The largest value counted in bucket i
+                auto const bound =
+                    i == 0 ? 0 : ~std::uint64_t{0} >> (64 - i);
+                return Duration{std::min(bound, max_.load())};
+            }
+        }
+        return max();
+    }
+
+    Json::Value
+    json() const
+    {
+        Json::Value ret(Json::objectValue);
+        ret[jss::count] = std::to_string(count());
+        ret[jss::p50] = std::to_string(percentile(50).count());
+        ret[jss::p99] = std::to_string(percentile(99).count());
+        ret[jss::max] = std::to_string(max().count());
+        ret[jss::total] = std::to_string(total().count());
+        return ret;
+    }
+
+private:
+    // Bucket i counts the samples that need exactly i bits
+    std::array<std::atomic<std::uint64_t>, 65> counts_{};
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+}  // namespace ripple
+
+#endif
@@ -20,6 +20,7 @@
 #include <xrpld/overlay/Message.h>
 #include <xrpld/overlay/detail/TrafficCount.h>
 #include <cstdint>
+#include <optional>
 
 namespace ripple {
 
@@ -64,6 +65,47 @@ Message::totalSize(::google::protobuf::Message const& message)
     return messageSize(message) + compression::headerBytes;
 }
 
+// How hard to compress each type of message, or nothing if messages of the
+// type are not worth compressing. Manifests and validator lists are
+// compressed once and the result is sent to every peer, so they are worth
+// the slower, stronger compressor.
+static std::optional<compression::Effort>
+compressionPolicy(int type)
+{
+    using compression::Effort;
+    switch (type)
+    {
+        case protocol::mtMANIFESTS:
+        case protocol::mtVALIDATORLIST:
+        case protocol::mtVALIDATORLISTCOLLECTION:
+            return Effort::High;
+        case protocol::mtENDPOINTS:
+        case protocol::mtTRANSACTION:
+        case protocol::mtGET_LEDGER:
+        case protocol::mtLEDGER_DATA:
+        case protocol::mtGET_OBJECTS:
+        case protocol::mtREPLAY_DELTA_RESPONSE:
+        case protocol::mtTRANSACTIONS:
+            return Effort::Fast;
+        case protocol::mtPING:
+        case protocol::mtCLUSTER:
+        case protocol::mtPROPOSE_LEDGER:
+        case protocol::mtSTATUS_CHANGE:
+        case protocol::mtHAVE_SET:
+        case protocol::mtVALIDATION:
+        case protocol::mtGET_PEER_SHARD_INFO:
+        case protocol::mtPEER_SHARD_INFO:
+        case protocol::mtPROOF_PATH_REQ:
+        case protocol::mtPROOF_PATH_RESPONSE:
+        case protocol::mtREPLAY_DELTA_REQ:
+        case protocol::mtGET_PEER_SHARD_INFO_V2:
+        case protocol::mtPEER_SHARD_INFO_V2:
+        case protocol::mtHAVE_TRANSACTIONS:
+            break;
+    }
+    return std::nullopt;
+}
+
 void
 Message::compress()
 {
@@ -72,42 +114,11 @@ Message::compress()
 
     auto type = getType(buffer_.data());
 
-    bool const compressible = [&] {
-        if (messageBytes <= 70)
-            return false;
-        switch (type)
-        {
-            case protocol::mtMANIFESTS:
-            case protocol::mtENDPOINTS:
-            case protocol::mtTRANSACTION:
-            case protocol::mtGET_LEDGER:
-            case protocol::mtLEDGER_DATA:
-            case protocol::mtGET_OBJECTS:
-            case protocol::mtVALIDATORLIST:
-            case protocol::mtVALIDATORLISTCOLLECTION:
-            case protocol::mtREPLAY_DELTA_RESPONSE:
-            case protocol::mtTRANSACTIONS:
-                return true;
-            case protocol::mtPING:
-            case protocol::mtCLUSTER:
-            case protocol::mtPROPOSE_LEDGER:
-            case protocol::mtSTATUS_CHANGE:
-            case protocol::mtHAVE_SET:
-            case protocol::mtVALIDATION:
-            case protocol::mtGET_PEER_SHARD_INFO:
-            case protocol::mtPEER_SHARD_INFO:
-            case protocol::mtPROOF_PATH_REQ:
-            case protocol::mtPROOF_PATH_RESPONSE:
-            case protocol::mtREPLAY_DELTA_REQ:
-            case protocol::mtGET_PEER_SHARD_INFO_V2:
-            case protocol::mtPEER_SHARD_INFO_V2:
-            case protocol::mtHAVE_TRANSACTIONS:
-                break;
-        }
-        return false;
-    }();
+    auto const effort = messageBytes <= 70
+        ? std::nullopt
+        : compressionPolicy(type);
 
-    if (compressible)
+    if (effort)
     {
         auto payload = static_cast<void const*>(buffer_.data() + headerBytes);
 
@@ -117,7 +128,9 @@ Message::compress()
             [&](std::size_t inSize) {  // size of required compressed buffer
                 bufferCompressed_.resize(inSize + headerBytesCompressed);
                 return (bufferCompressed_.data() + headerBytesCompressed);
-            });
+            },
+            Algorithm::LZ4,
+            *effort);
 
         if (compressedSize <
             (messageBytes - (headerBytesCompressed - headerBytes)))
@@ -28,6 +28,7 @@
 #include <xrpld/overlay/Cluster.h>
 #include <xrpld/overlay/detail/ConnectAttempt.h>
 #include <xrpld/overlay/detail/PeerImp.h>
+#include <xrpld/overlay/detail/Tuning.h>
 #include <xrpld/overlay/predicates.h>
 #include <xrpld/peerfinder/make_Manager.h>
 #include <xrpld/rpc/handlers/GetCounts.h>
@@ -140,6 +141,11 @@ OverlayImpl::OverlayImpl(
     , next_id_(1)
     , timer_count_(0)
     , slots_(app.logs(), *this)
+    , txVerifier_(std::make_shared<BatchVerifier>(
+          app,
+          io_service,
+          setup.txVerifyWindow,
+          setup.txVerifyJobs))
     , m_stats(
           std::bind(&OverlayImpl::collect_metrics, this),
           collector,
@@ -553,6 +559,7 @@ OverlayImpl::stop()
         cond_.wait(lock, [this] { return list_.empty(); });
     }
     m_peerFinder->stop();
+    txVerifier_->stop();
 }
 
 //------------------------------------------------------------------------------
@@ -576,6 +583,8 @@ OverlayImpl::onWrite(beast::PropertyStream::Map& stream)
             item["messages_in"] = std::to_string(i.messagesIn.load());
             item["bytes_out"] = std::to_string(i.bytesOut.load());
             item["messages_out"] = std::to_string(i.messagesOut.load());
+            item["raw_bytes_in"] = std::to_string(i.rawBytesIn.load());
+            item["raw_bytes_out"] = std::to_string(i.rawBytesOut.load());
         }
     }
 }
@@ -674,9 +683,10 @@ void
 OverlayImpl::reportTraffic(
     TrafficCount::category cat,
     bool isInbound,
-    int number)
+    int number,
+    int rawNumber)
 {
-    m_traffic.addCount(cat, isInbound, number);
+    m_traffic.addCount(cat, isInbound, number, rawNumber);
 }
 
 Json::Value
@@ -1149,14 +1159,14 @@ OverlayImpl::getActivePeers() const
     return ret;
 }
 
-Overlay::PeerSequence
+std::vector<std::shared_ptr<PeerImp>>
 OverlayImpl::getActivePeers(
     std::set<Peer::id_t> const& toSkip,
     std::size_t& active,
     std::size_t& disabled,
     std::size_t& enabledInSkip) const
 {
-    Overlay::PeerSequence ret;
+    std::vector<std::shared_ptr<PeerImp>> ret;
     std::lock_guard lock(mutex_);
 
     active = ids_.size();
@@ -1324,15 +1334,35 @@ OverlayImpl::relay(
     }
 
     // We have more peers than the minimum (disabled + minimum enabled),
-    // relay to all disabled and some randomly selected enabled that
-    // do not have the transaction.
+    // relay to all disabled and some selected enabled that do not have
+    // the transaction.
     auto enabledTarget = app_.config().TX_REDUCE_RELAY_MIN_PEERS +
         (total - minRelay) * app_.config().TX_RELAY_PERCENTAGE / 100;
 
     txMetrics_.addMetrics(enabledTarget, toSkip.size(), disabled);
 
     if (enabledTarget > enabledInSkip)
-        std::shuffle(peers.begin(), peers.end(), default_prng());
+    {
+        // Prefer the peers that rarely relay a transaction to us first.
+        // The others get most transactions before we do, so the full
+        // transaction from us would likely be a duplicate; they still get
+        // its hash. Peers with a similar share are picked at random.
+        std::vector<std::pair<std::uint32_t, std::shared_ptr<PeerImp>>>
+            ranked;
+        ranked.reserve(peers.size());
+        for (auto& p : peers)
+        {
+            auto const bucket = p->txFirstShare() / Tuning::txSourceBucket;
+            ranked.emplace_back(bucket, std::move(p));
+        }
+        std::shuffle(ranked.begin(), ranked.end(), default_prng());
+        std::stable_sort(
+            ranked.begin(), ranked.end(), [](auto const& a, auto const& b) {
+                return a.first < b.first;
+            });
+        for (std::size_t i = 0; i < ranked.size(); ++i)
+            peers[i] = std::move(ranked[i].second);
+    }
 
     JLOG(journal_.trace()) << "relaying tx, total peers " << peers.size()
                            << " selected " << enabledTarget << " skip "
@@ -1542,6 +1572,14 @@ setup_Overlay(BasicConfig const& config)
         if (setup.ipLimit < 0)
             Throw<std::runtime_error>("Configured IP limit is invalid");
 
+        std::uint32_t txVerifyWindow = 0;
+        set(txVerifyWindow, "tx_verify_window", section);
+        if (txVerifyWindow > 1000)
+            Throw<std::runtime_error>(
+                "Configured transaction verify window is invalid");
+        setup.txVerifyWindow = std::chrono::milliseconds(txVerifyWindow);
+        set(setup.txVerifyJobs, "tx_verify_jobs", section);
+
         std::string ip;
         set(ip, "public_ip", section);
         if (!ip.empty())
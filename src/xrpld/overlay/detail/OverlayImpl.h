@@ -25,6 +25,7 @@
 #include <xrpld/overlay/Message.h>
 #include <xrpld/overlay/Overlay.h>
 #include <xrpld/overlay/Slot.h>
+#include <xrpld/overlay/detail/BatchVerifier.h>
 #include <xrpld/overlay/detail/Handshake.h>
 #include <xrpld/overlay/detail/TrafficCount.h>
 #include <xrpld/overlay/detail/TxMetrics.h>
@@ -130,6 +131,9 @@ private:
     // Transaction reduce-relay metrics
     metrics::TxMetrics txMetrics_;
 
+    // Checks the signatures of relayed transactions in batches
+    std::shared_ptr<BatchVerifier> const txVerifier_;
+
     // A message with the list of manifests we send to peers
     std::shared_ptr<Message> manifestMessage_;
     // Used to track whether we need to update the cached list of manifests
@@ -178,6 +182,12 @@ public:
         return setup_;
     }
 
+    BatchVerifier&
+    txVerifier()
+    {
+        return *txVerifier_;
+    }
+
     Handoff
     onHandoff(
         std::unique_ptr<stream_type>&& bundle,
@@ -208,7 +218,7 @@ public:
            feature enabled and in toSkip
        @return active peers less peers in toSkip
      */
-    PeerSequence
+    std::vector<std::shared_ptr<PeerImp>>
     getActivePeers(
         std::set<Peer::id_t> const& toSkip,
         std::size_t& active,
@@ -348,7 +358,42 @@ public:
     makePrefix(std::uint32_t id);
 
     void
-    reportTraffic(TrafficCount::category cat, bool isInbound, int bytes);
+    reportTraffic(
+        TrafficCount::category cat,
+        bool isInbound,
+        int bytes,
+        int rawBytes);
+
+    /** Record the time taken to answer a peer's request for objects, and
+        count the objects requested and found.
+    */
+    template <class Rep, class Period>
+    void
+    reportGetObjects(
+        std::chrono::duration<Rep, Period> const& elapsed,
+        std::size_t requested,
+        std::size_t found)
+    {
+        using value_type = beast::insight::Counter::value_type;
+        m_stats.getObjectsTime.notify(elapsed);
+        m_stats.getObjectsRequested += static_cast<value_type>(requested);
+        m_stats.getObjectsFound += static_cast<value_type>(found);
+    }
+
+    /** Record the round trip time of a ping to a peer. */
+    void
+    reportPeerLatency(std::chrono::milliseconds rtt)
+    {
+        m_stats.peerLatency.notify(rtt);
+    }
+
+    /** Record the time taken to handle a message from a peer. */
+    template <class Rep, class Period>
+    void
+    reportMessageTime(std::chrono::duration<Rep, Period> const& elapsed)
+    {
+        m_stats.messageTime.notify(elapsed);
+    }
 
     void
     incJqTransOverflow() override
@@ -454,6 +499,18 @@ public:
         txMetrics_.addMetrics(args...);
     }
 
+    /** Add the size of a transaction that a peer relayed to us after
+        another peer already had. */
+    void
+    addTxDuplicate(std::uint32_t size)
+    {
+        if (!strand_.running_in_this_thread())
+            return post(
+                strand_, std::bind(&OverlayImpl::addTxDuplicate, this, size));
+
+        txMetrics_.addDuplicate(size);
+    }
+
 private:
     void
     squelch(
@@ -580,12 +637,16 @@ private:
             , bytesOut(collector->make_gauge(name, "Bytes_Out"))
             , messagesIn(collector->make_gauge(name, "Messages_In"))
             , messagesOut(collector->make_gauge(name, "Messages_Out"))
+            , rawBytesIn(collector->make_gauge(name, "Raw_Bytes_In"))
+            , rawBytesOut(collector->make_gauge(name, "Raw_Bytes_Out"))
         {
         }
         beast::insight::Gauge bytesIn;
         beast::insight::Gauge bytesOut;
         beast::insight::Gauge messagesIn;
         beast::insight::Gauge messagesOut;
+        beast::insight::Gauge rawBytesIn;
+        beast::insight::Gauge rawBytesOut;
     };
 
     struct Stats
@@ -597,12 +658,25 @@ private:
             std::vector<TrafficGauges>&& trafficGauges_)
             : peerDisconnects(
                   collector->make_gauge("Overlay", "Peer_Disconnects"))
+            , getObjectsTime(
+                  collector->make_event("Overlay", "GetObjects_Time"))
+            , getObjectsRequested(
+                  collector->make_counter("Overlay", "GetObjects_Requested"))
+            , getObjectsFound(
+                  collector->make_counter("Overlay", "GetObjects_Found"))
+            , peerLatency(collector->make_event("Overlay", "Peer_Latency"))
+            , messageTime(collector->make_event("Overlay", "Message_Time"))
             , trafficGauges(std::move(trafficGauges_))
             , hook(collector->make_hook(handler))
         {
         }
 
         beast::insight::Gauge peerDisconnects;
+        beast::insight::Event getObjectsTime;
+        beast::insight::Counter getObjectsRequested;
+        beast::insight::Counter getObjectsFound;
+        beast::insight::Event peerLatency;
+        beast::insight::Event messageTime;
         std::vector<TrafficGauges> trafficGauges;
         beast::insight::Hook hook;
     };
@@ -624,6 +698,8 @@ private:
             m_stats.trafficGauges[i].bytesOut = counts[i].bytesOut;
             m_stats.trafficGauges[i].messagesIn = counts[i].messagesIn;
             m_stats.trafficGauges[i].messagesOut = counts[i].messagesOut;
+            m_stats.trafficGauges[i].rawBytesIn = counts[i].rawBytesIn;
+            m_stats.trafficGauges[i].rawBytesOut = counts[i].rawBytesOut;
         }
         m_stats.peerDisconnects = getPeerDisconnect();
     }
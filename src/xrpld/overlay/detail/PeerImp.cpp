@@ -59,6 +59,39 @@ std::chrono::milliseconds constexpr peerHighLatency{300};
 
 /** How often we PING the peer to check for latency and sendq probe */
 std::chrono::seconds constexpr peerTimerInterval{60};
+
+/** Return the lane of the send queue for a message. */
+PeerImp::SendLane
+sendLane(TrafficCount::category category)
+{
+    using category_t = TrafficCount::category;
+    switch (category)
+    {
+        case category_t::proposal:
+        case category_t::validation:
+            return PeerImp::SendLane::consensus;
+
+        // Transaction set candidates are needed to reach consensus, so they
+        // are not bulk even though they are ledger data.
+        case category_t::ld_txn_share:
+        case category_t::ld_asn_share:
+        case category_t::ld_share:
+        case category_t::share_hash_ledger:
+        case category_t::share_hash_tx:
+        case category_t::share_hash_txnode:
+        case category_t::share_hash_asnode:
+        case category_t::share_cas_object:
+        case category_t::share_fetch_pack:
+        case category_t::share_hash:
+        case category_t::proof_path_response:
+        case category_t::replay_delta_response:
+        case category_t::requested_transactions:
+            return PeerImp::SendLane::bulk;
+
+        default:
+            return PeerImp::SendLane::normal;
+    }
+}
 }  // namespace
 
 PeerImp::PeerImp(
@@ -249,12 +282,25 @@ PeerImp::send(std::shared_ptr<Message> const& m)
     if (validator && !squelch_.expireSquelch(*validator))
         return;
 
-    overlay_.reportTraffic(
-        safe_cast<TrafficCount::category>(m->getCategory()),
-        false,
-        static_cast<int>(m->getBuffer(compressionEnabled_).size()));
+    auto const category = safe_cast<TrafficCount::category>(m->getCategory());
+    auto const lane = sendLane(category);
+    auto& queue = send_queue_[static_cast<std::size_t>(lane)];
 
-    auto sendq_size = send_queue_.size();
+    if (lane == SendLane::bulk && queue.size() >= Tuning::maxBulkSendQueue)
+    {
+        JLOG(p_journal_.debug()) << "send: dropping reply, send queue full";
+        return;
+    }
+
+    {
+        auto const bytes =
+            static_cast<int>(m->getBuffer(compressionEnabled_).size());
+        auto const rawBytes = static_cast<int>(m->getBufferSize());
+        overlay_.reportTraffic(category, false, bytes, rawBytes);
+        traffic_.addCount(category, false, bytes, rawBytes);
+    }
+
+    auto sendq_size = sendQueueSize();
 
     if (sendq_size < Tuning::targetSendQueue)
     {
@@ -271,22 +317,12 @@ PeerImp::send(std::shared_ptr<Message> const& m)
              << " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    queue.push_back(m);
 
-    if (sendq_size != 0)
+    if (!writing_.empty())
         return;
 
-    boost::asio::async_write(
-        stream_,
-        boost::asio::buffer(
-            send_queue_.front()->getBuffer(compressionEnabled_)),
-        bind_executor(
-            strand_,
-            std::bind(
-                &PeerImp::onWriteMessage,
-                shared_from_this(),
-                std::placeholders::_1,
-                std::placeholders::_2)));
+    writeQueued();
 }
 
 void
@@ -337,6 +373,29 @@ PeerImp::removeTxQueue(uint256 const& hash)
     JLOG(p_journal_.trace()) << "removeTxQueue " << removed;
 }
 
+std::uint32_t
+PeerImp::txFirstShare() const
+{
+    auto const first = txFirst_.load();
+    auto const total = first + txDuplicate_.load();
+    if (total == 0)
+        return 0;
+    return first * 1000 / total;
+}
+
+void
+PeerImp::countRelayedTx(bool first)
+{
+    // Only called while handling this peer's messages, so the counters are
+    // atomic just to be read from other threads.
+    ++(first ? txFirst_ : txDuplicate_);
+    if (txFirst_.load() + txDuplicate_.load() >= Tuning::txSourceWindow)
+    {
+        txFirst_ = txFirst_.load() / 2;
+        txDuplicate_ = txDuplicate_.load() / 2;
+    }
+}
+
 void
 PeerImp::charge(Resource::Charge const& fee)
 {
@@ -488,6 +547,27 @@ PeerImp::json()
         std::to_string(metrics_.recv.average_bytes());
     ret[jss::metrics][jss::avg_bps_sent] =
         std::to_string(metrics_.sent.average_bytes());
+    if (auto const writes = writes_.load())
+        ret[jss::metrics][jss::avg_msgs_per_write] =
+            static_cast<double>(messagesWritten_) / writes;
+    if (rtt_.count() != 0)
+        ret[jss::metrics][jss::rtt_ms] = rtt_.json();
+    if (processing_.count() != 0)
+        ret[jss::metrics][jss::processing_us] = processing_.json();
+
+    Json::Value traffic(Json::objectValue);
+    for (auto const& i : traffic_.getCounts())
+    {
+        if (!i)
+            continue;
+        Json::Value& item = traffic[i.name];
+        item[jss::bytes_in] = std::to_string(i.bytesIn.load());
+        item[jss::messages_in] = std::to_string(i.messagesIn.load());
+        item[jss::bytes_out] = std::to_string(i.bytesOut.load());
+        item[jss::messages_out] = std::to_string(i.messagesOut.load());
+    }
+    if (traffic.size() != 0)
+        ret[jss::traffic] = std::move(traffic);
 
     return ret;
 }
@@ -640,7 +720,7 @@ PeerImp::gracefulClose()
     assert(socket_.is_open());
     assert(!gracefulClose_);
     gracefulClose_ = true;
-    if (send_queue_.size() > 0)
+    if (sendQueueSize() > 0)
         return;
     setTimer();
     stream_.async_shutdown(bind_executor(
@@ -943,6 +1023,68 @@ PeerImp::onReadMessage(error_code ec, std::size_t bytes_transferred)
                 std::placeholders::_2)));
 }
 
+void
+PeerImp::writeQueued()
+{
+    assert(strand_.running_in_this_thread());
+    assert(sendQueueSize() != 0 && writing_.empty());
+
+    // Gather the queued messages into a single write, so that a burst of
+    // small messages costs one write instead of one each. Messages are
+    // taken from the most urgent lanes first, and kept in writing_, which
+    // keeps their buffers alive, until written.
+    std::vector<boost::asio::const_buffer> buffers;
+    std::size_t bytes = 0;
+    for (auto& queue : send_queue_)
+    {
+        while (!queue.empty())
+        {
+            auto const& buffer = queue.front()->getBuffer(compressionEnabled_);
+            if (!writing_.empty() &&
+                bytes + buffer.size() > Tuning::sendQueueWriteBytes)
+                break;
+            buffers.emplace_back(buffer.data(), buffer.size());
+            bytes += buffer.size();
+            writing_.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+
+        if (!queue.empty())
+            break;
+    }
+
+    ++writes_;
+    messagesWritten_ += writing_.size();
+
+    boost::asio::async_write(
+        stream_,
+        buffers,
+        bind_executor(
+            strand_,
+            std::bind(
+                &PeerImp::onWriteMessage,
+                shared_from_this(),
+                std::placeholders::_1,
+                std::placeholders::_2)));
+}
+
+std::size_t
+PeerImp::sendQueueSize() const
+{
+    auto size = writing_.size();
+    for (auto const& queue : send_queue_)
+        size += queue.size();
+    return size;
+}
+
+bool
+PeerImp::sendQueueFull() const
+{
+    return sendQueueSize() >= Tuning::dropSendQueue ||
+        send_queue_[static_cast<std::size_t>(SendLane::bulk)].size() >=
+        Tuning::maxBulkSendQueue;
+}
+
 void
 PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
 {
@@ -962,23 +1104,9 @@ PeerImp::onWriteMessage(error_code ec, std::size_t bytes_transferred)
 
     metrics_.sent.add_message(bytes_transferred);
 
-    assert(!send_queue_.empty());
-    send_queue_.pop();
-    if (!send_queue_.empty())
-    {
-        // Timeout on writes only
-        return boost::asio::async_write(
-            stream_,
-            boost::asio::buffer(
-                send_queue_.front()->getBuffer(compressionEnabled_)),
-            bind_executor(
-                strand_,
-                std::bind(
-                    &PeerImp::onWriteMessage,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
-    }
+    writing_.clear();
+    if (sendQueueSize() != 0)
+        return writeQueued();
 
     if (gracefulClose_)
     {
@@ -1014,8 +1142,19 @@ PeerImp::onMessageBegin(
     load_event_ =
         app_.getJobQueue().makeLoadEvent(jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
+    messageBegin_ = clock_type::now();
+    messageJob_ = false;
     auto const category = TrafficCount::categorize(*m, type, true);
-    overlay_.reportTraffic(category, true, static_cast<int>(size));
+    overlay_.reportTraffic(
+        category,
+        true,
+        static_cast<int>(size),
+        static_cast<int>(uncompressed_size));
+    traffic_.addCount(
+        category,
+        true,
+        static_cast<int>(size),
+        static_cast<int>(uncompressed_size));
     using namespace protocol;
     if ((type == MessageType::mtTRANSACTION ||
          type == MessageType::mtHAVE_TRANSACTIONS ||
@@ -1044,6 +1183,38 @@ PeerImp::onMessageEnd(
 {
     load_event_.reset();
     charge(fee_);
+
+    // Messages handled by a job are recorded when the job is done
+    if (!messageJob_)
+        recordProcessing(messageBegin_);
+}
+
+void
+PeerImp::addMessageJob(
+    JobType type,
+    std::string const& name,
+    std::function<void()> job)
+{
+    messageJob_ = true;
+    app_.getJobQueue().addJob(
+        type,
+        name,
+        [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+         begin = messageBegin_,
+         job = std::move(job)]() {
+            job();
+            if (auto peer = weak.lock())
+                peer->recordProcessing(begin);
+        });
+}
+
+void
+PeerImp::recordProcessing(clock_type::time_point begin)
+{
+    auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - begin);
+    processing_.add(elapsed);
+    overlay_.reportMessageTime(elapsed);
 }
 
 void
@@ -1060,7 +1231,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMManifests> const& m)
     if (s > 100)
         fee_ = Resource::feeMediumBurdenPeer;
 
-    app_.getJobQueue().addJob(
+    addMessageJob(
         jtMANIFEST, "receiveManifests", [this, that = shared_from_this(), m]() {
             overlay_.onManifests(m, that);
         });
@@ -1091,6 +1262,9 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMPing> const& m)
             auto const rtt = std::chrono::round<std::chrono::milliseconds>(
                 clock_type::now() - lastPingTime_);
 
+            rtt_.add(rtt);
+            overlay_.reportPeerLatency(rtt);
+
             std::lock_guard sl(recentLock_);
 
             if (latency_)
@@ -1552,14 +1726,38 @@ PeerImp::handleTransaction(
                 JLOG(p_journal_.debug()) << "Ignoring known bad tx " << txID;
             }
 
-            // Erase only if the server has seen this tx. If the server has not
-            // seen this tx then the tx could not has been queued for this peer.
-            else if (eraseTxQueue && txReduceRelayEnabled())
-                removeTxQueue(txID);
+            else if (eraseTxQueue)
+            {
+                countRelayedTx(false);
+
+                auto const size = static_cast<int>(m->ByteSizeLong());
+                overlay_.reportTraffic(
+                    TrafficCount::category::transaction_duplicate,
+                    true,
+                    size,
+                    size);
+                traffic_.addCount(
+                    TrafficCount::category::transaction_duplicate,
+                    true,
+                    size,
+                    size);
+                if (txReduceRelayEnabled() ||
+                    app_.config().TX_REDUCE_RELAY_METRICS)
+                    overlay_.addTxDuplicate(size);
+
+                // Erase only if the server has seen this tx. If the server has
+                // not seen this tx then the tx could not has been queued for
+                // this peer.
+                if (txReduceRelayEnabled())
+                    removeTxQueue(txID);
+            }
 
             return;
         }
 
+        if (eraseTxQueue)
+            countRelayedTx(true);
+
         JLOG(p_journal_.debug()) << "Got tx " << txID;
 
         bool checkSignature = true;
@@ -1588,7 +1786,8 @@ PeerImp::handleTransaction(
                 << "No new transactions until synchronized";
         }
         else if (
-            app_.getJobQueue().getJobCount(jtTRANSACTION) >
+            app_.getJobQueue().getJobCount(jtTRANSACTION) +
+                static_cast<int>(overlay_.txVerifier().size()) >
             app_.config().MAX_TRANSACTIONS)
         {
             overlay_.incJqTransOverflow();
@@ -1596,16 +1795,25 @@ PeerImp::handleTransaction(
         }
         else
         {
-            app_.getJobQueue().addJob(
-                jtTRANSACTION,
-                "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                 flags,
-                 checkSignature,
-                 stx]() {
-                    if (auto peer = weak.lock())
-                        peer->checkTransaction(flags, checkSignature, stx);
-                });
+            auto check = [&app = app_,
+                          weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                          flags,
+                          checkSignature,
+                          stx]() {
+                app.getJobQueue().addJob(
+                    jtTRANSACTION,
+                    "recvTransaction->checkTransaction",
+                    [weak, flags, checkSignature, stx]() {
+                        if (auto peer = weak.lock())
+                            peer->checkTransaction(flags, checkSignature, stx);
+                    });
+            };
+
+            // With batching enabled, the signature is checked first and
+            // checkTransaction then finds the result cached.
+            if (!checkSignature ||
+                !overlay_.txVerifier().add(stx, std::move(check)))
+                check();
         }
     }
     catch (std::exception const& ex)
@@ -1706,7 +1914,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetLedger> const& m)
 
     // Queue a job to process the request
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(jtLEDGER_REQ, "recvGetLedger", [weak, m]() {
+    addMessageJob(jtLEDGER_REQ, "recvGetLedger", [weak, m]() {
         if (auto peer = weak.lock())
             peer->processLedgerRequest(m);
     });
@@ -1724,26 +1932,25 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMProofPathRequest> const& m)
 
     fee_ = Resource::feeMediumBurdenPeer;
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(
-        jtREPLAY_REQ, "recvProofPathRequest", [weak, m]() {
-            if (auto peer = weak.lock())
+    addMessageJob(jtREPLAY_REQ, "recvProofPathRequest", [weak, m]() {
+        if (auto peer = weak.lock())
+        {
+            auto reply =
+                peer->ledgerReplayMsgHandler_.processProofPathRequest(m);
+            if (reply.has_error())
             {
-                auto reply =
-                    peer->ledgerReplayMsgHandler_.processProofPathRequest(m);
-                if (reply.has_error())
-                {
-                    if (reply.error() == protocol::TMReplyError::reBAD_REQUEST)
-                        peer->charge(Resource::feeInvalidRequest);
-                    else
-                        peer->charge(Resource::feeRequestNoReply);
-                }
+                if (reply.error() == protocol::TMReplyError::reBAD_REQUEST)
+                    peer->charge(Resource::feeInvalidRequest);
                 else
-                {
-                    peer->send(std::make_shared<Message>(
-                        reply, protocol::mtPROOF_PATH_RESPONSE));
-                }
+                    peer->charge(Resource::feeRequestNoReply);
             }
-        });
+            else
+            {
+                peer->send(std::make_shared<Message>(
+                    reply, protocol::mtPROOF_PATH_RESPONSE));
+            }
+        }
+    });
 }
 
 void
@@ -1773,26 +1980,25 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMReplayDeltaRequest> const& m)
 
     fee_ = Resource::feeMediumBurdenPeer;
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(
-        jtREPLAY_REQ, "recvReplayDeltaRequest", [weak, m]() {
-            if (auto peer = weak.lock())
+    addMessageJob(jtREPLAY_REQ, "recvReplayDeltaRequest", [weak, m]() {
+        if (auto peer = weak.lock())
+        {
+            auto reply =
+                peer->ledgerReplayMsgHandler_.processReplayDeltaRequest(m);
+            if (reply.has_error())
             {
-                auto reply =
-                    peer->ledgerReplayMsgHandler_.processReplayDeltaRequest(m);
-                if (reply.has_error())
-                {
-                    if (reply.error() == protocol::TMReplyError::reBAD_REQUEST)
-                        peer->charge(Resource::feeInvalidRequest);
-                    else
-                        peer->charge(Resource::feeRequestNoReply);
-                }
+                if (reply.error() == protocol::TMReplyError::reBAD_REQUEST)
+                    peer->charge(Resource::feeInvalidRequest);
                 else
-                {
-                    peer->send(std::make_shared<Message>(
-                        reply, protocol::mtREPLAY_DELTA_RESPONSE));
-                }
+                    peer->charge(Resource::feeRequestNoReply);
             }
-        });
+            else
+            {
+                peer->send(std::make_shared<Message>(
+                    reply, protocol::mtREPLAY_DELTA_RESPONSE));
+            }
+        }
+    });
 }
 
 void
@@ -1894,14 +2100,13 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMLedgerData> const& m)
     if (m->type() == protocol::liTS_CANDIDATE)
     {
         std::weak_ptr<PeerImp> weak{shared_from_this()};
-        app_.getJobQueue().addJob(
-            jtTXN_DATA, "recvPeerData", [weak, ledgerHash, m]() {
-                if (auto peer = weak.lock())
-                {
-                    peer->app_.getInboundTransactions().gotData(
-                        ledgerHash, peer, m);
-                }
-            });
+        addMessageJob(jtTXN_DATA, "recvPeerData", [weak, ledgerHash, m]() {
+            if (auto peer = weak.lock())
+            {
+                peer->app_.getInboundTransactions().gotData(
+                    ledgerHash, peer, m);
+            }
+        });
         return;
     }
 
@@ -2005,7 +2210,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMProposeSet> const& m)
             calcNodeID(app_.validatorManifests().getMasterKey(publicKey))});
 
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(
+    addMessageJob(
         isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut,
         "recvPropose->checkPropose",
         [weak, isTrusted, m, proposal]() {
@@ -2608,7 +2813,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMValidation> const& m)
             }();
 
             std::weak_ptr<PeerImp> weak = shared_from_this();
-            app_.getJobQueue().addJob(
+            addMessageJob(
                 isTrusted ? jtVALIDATION_t : jtVALIDATION_ut,
                 name,
                 [weak, val, m, key]() {
@@ -2641,7 +2846,7 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
     if (packet.query())
     {
         // this is a query
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (sendQueueFull())
         {
             JLOG(p_journal_.debug()) << "GetObject: Large send queue";
             return;
@@ -2664,11 +2869,10 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
             }
 
             std::weak_ptr<PeerImp> weak = shared_from_this();
-            app_.getJobQueue().addJob(
-                jtREQUESTED_TXN, "doTransactions", [weak, m]() {
-                    if (auto peer = weak.lock())
-                        peer->doTransactions(m);
-                });
+            addMessageJob(jtREQUESTED_TXN, "doTransactions", [weak, m]() {
+                if (auto peer = weak.lock())
+                    peer->doTransactions(m);
+            });
             return;
         }
 
@@ -2694,43 +2898,64 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
             reply.set_ledgerhash(packet.ledgerhash());
         }
 
-        // This is a very minimal implementation
+        // Look up every requested object in one batch, so that a slow
+        // read doesn't hold up the reads behind it.
+        std::vector<uint256> hashes;
+        std::vector<int> requested;
+        hashes.reserve(packet.objects_size());
+        requested.reserve(packet.objects_size());
         for (int i = 0; i < packet.objects_size(); ++i)
         {
             auto const& obj = packet.objects(i);
             if (obj.has_hash() && stringIsUint256Sized(obj.hash()))
             {
-                uint256 const hash{obj.hash()};
-                // VFALCO TODO Move this someplace more sensible so we dont
-                //             need to inject the NodeStore interfaces.
+                hashes.emplace_back(obj.hash());
+                requested.push_back(i);
+            }
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        // VFALCO TODO Move this someplace more sensible so we dont
+        //             need to inject the NodeStore interfaces.
+        auto const nodeObjects = app_.getNodeStore().fetchBatch(hashes);
+        auto const shardStore = app_.getShardStore();
+
+        reply.mutable_objects()->Reserve(hashes.size());
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+        {
+            auto const& obj = packet.objects(requested[i]);
+            auto const& hash = hashes[i];
+            auto nodeObject = nodeObjects[i];
+            if (!nodeObject && shardStore)
+            {
                 std::uint32_t seq{obj.has_ledgerseq() ? obj.ledgerseq() : 0};
-                auto nodeObject{app_.getNodeStore().fetchNodeObject(hash, seq)};
-                if (!nodeObject)
-                {
-                    if (auto shardStore = app_.getShardStore())
-                    {
-                        if (seq >= shardStore->earliestLedgerSeq())
-                            nodeObject = shardStore->fetchNodeObject(hash, seq);
-                    }
-                }
-                if (nodeObject)
-                {
-                    protocol::TMIndexedObject& newObj = *reply.add_objects();
-                    newObj.set_hash(hash.begin(), hash.size());
-                    newObj.set_data(
-                        &nodeObject->getData().front(),
-                        nodeObject->getData().size());
-
-                    if (obj.has_nodeid())
-                        newObj.set_index(obj.nodeid());
-                    if (obj.has_ledgerseq())
-                        newObj.set_ledgerseq(obj.ledgerseq());
-
-                    // VFALCO NOTE "seq" in the message is obsolete
-                }
+                if (seq >= shardStore->earliestLedgerSeq())
+                    nodeObject = shardStore->fetchNodeObject(hash, seq);
+            }
+            if (nodeObject)
+            {
+                auto const& data = nodeObject->getData();
+                protocol::TMIndexedObject& newObj = *reply.add_objects();
+                newObj.set_hash(hash.begin(), hash.size());
+                newObj.set_data(data.data(), data.size());
+
+                if (obj.has_nodeid())
+                    newObj.set_index(obj.nodeid());
+                if (obj.has_ledgerseq())
+                    newObj.set_ledgerseq(obj.ledgerseq());
+
+                // VFALCO NOTE "seq" in the message is obsolete
             }
         }
 
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+        overlay_.reportGetObjects(elapsed, hashes.size(), reply.objects_size());
+        JLOG(p_journal_.trace())
+            << "GetObj: looked up " << hashes.size() << " objects in "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                   .count()
+            << "us";
+
         JLOG(p_journal_.trace()) << "GetObj: " << reply.objects_size() << " of "
                                  << packet.objects_size();
         send(std::make_shared<Message>(reply, protocol::mtGET_OBJECTS));
@@ -2804,11 +3029,10 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMHaveTransactions> const& m)
     }
 
     std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue().addJob(
-        jtMISSING_TXN, "handleHaveTransactions", [weak, m]() {
-            if (auto peer = weak.lock())
-                peer->handleHaveTransactions(m);
-        });
+    addMessageJob(jtMISSING_TXN, "handleHaveTransactions", [weak, m]() {
+        if (auto peer = weak.lock())
+            peer->handleHaveTransactions(m);
+    });
 }
 
 void
@@ -2984,7 +3208,7 @@ PeerImp::doFetchPack(const std::shared_ptr<protocol::TMGetObjectByHash>& packet)
     std::weak_ptr<PeerImp> weak = shared_from_this();
     auto elapsed = UptimeClock::now();
     auto const pap = &app_;
-    app_.getJobQueue().addJob(
+    addMessageJob(
         jtPACK, "MakeFetchPack", [pap, weak, packet, hash, elapsed]() {
             pap->getLedgerMaster().makeFetchPack(weak, packet, hash, elapsed);
         });
@@ -3476,7 +3700,7 @@ PeerImp::processLedgerRequest(std::shared_ptr<protocol::TMGetLedger> const& m)
     }
     else
     {
-        if (send_queue_.size() >= Tuning::dropSendQueue)
+        if (sendQueueFull())
         {
             JLOG(p_journal_.debug())
                 << "processLedgerRequest: Large send queue";
@@ -3491,6 +3715,8 @@ PeerImp::processLedgerRequest(std::shared_ptr<protocol::TMGetLedger> const& m)
         if (ledger = getLedger(m); !ledger)
             return;
 
+        prefetchNextLedger(ledger);
+
         // Fill out the reply
         auto const ledgerHash{ledger->info().hash};
         ledgerData.set_ledgerhash(ledgerHash.begin(), ledgerHash.size());
@@ -3616,6 +3842,61 @@ PeerImp::processLedgerRequest(std::shared_ptr<protocol::TMGetLedger> const& m)
     send(std::make_shared<Message>(ledgerData, protocol::mtLEDGER_DATA));
 }
 
+void
+PeerImp::prefetchNextLedger(std::shared_ptr<Ledger const> const& ledger)
+{
+    // A peer acquiring consecutive ledgers moves on to each ledger after
+    // asking for its parent
+    auto const seq = ledger->info().seq;
+    if (lastLedgerRequested_.exchange(seq) + 1 != seq)
+        return;
+
+    auto const next = seq + 1;
+    if (lastLedgerPrefetched_.exchange(next) >= next)
+        return;
+
+    if (app_.getFeeTrack().isLoadedLocal())
+        return;
+
+    std::weak_ptr<PeerImp> weak = shared_from_this();
+    app_.getJobQueue().addJob(
+        jtLEDGER_PREFETCH, "prefetchLedger", [weak, ledger, next]() {
+            auto const peer = weak.lock();
+            if (!peer)
+                return;
+
+            auto const nextLedger =
+                peer->app_.getLedgerMaster().getLedgerBySeq(next);
+            if (!nextLedger || nextLedger->info().parentHash !=
+                    ledger->info().hash)
+                return;
+
+            // The peer already has this ledger, so it will ask for the
+            // nodes of the next ledger that differ from it. Walking the
+            // differences loads them into the tree node cache.
+            int nodes = 0;
+            auto const visit = [&nodes](SHAMapTreeNode const&) {
+                return ++nodes < Tuning::maxPrefetchNodes;
+            };
+            try
+            {
+                nextLedger->stateMap().visitDifferences(
+                    &ledger->stateMap(), visit);
+                if (nodes < Tuning::maxPrefetchNodes)
+                    nextLedger->txMap().visitDifferences(nullptr, visit);
+            }
+            catch (SHAMapMissingNode const& e)
+            {
+                JLOG(peer->p_journal_.debug())
+                    << "prefetchLedger: " << e.what();
+                return;
+            }
+
+            JLOG(peer->p_journal_.debug()) << "prefetchLedger: loaded "
+                                           << nodes << " nodes of " << next;
+        });
+}
+
 int
 PeerImp::getScore(bool haveItem) const
 {
@@ -24,6 +24,7 @@
 #include <xrpld/app/ledger/detail/LedgerReplayMsgHandler.h>
 #include <xrpld/nodestore/ShardInfo.h>
 #include <xrpld/overlay/Squelch.h>
+#include <xrpld/overlay/detail/LatencyHistogram.h>
 #include <xrpld/overlay/detail/OverlayImpl.h>
 #include <xrpld/overlay/detail/ProtocolMessage.h>
 #include <xrpld/overlay/detail/ProtocolVersion.h>
@@ -40,9 +41,12 @@
 #include <boost/circular_buffer.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <optional>
-#include <queue>
 
 namespace ripple {
 
@@ -57,6 +61,19 @@ public:
     /** Whether the peer's view of the ledger converges or diverges from ours */
     enum class Tracking { diverged, unknown, converged };
 
+    /** The lanes of the send queue, most urgent first.
+
+        Each write takes messages from the most urgent lane that has any, so
+        proposals and validations do not wait behind replies to a peer that
+        is syncing from us.
+    */
+    enum class SendLane {
+        consensus,  // Proposals and validations
+        normal,     // Everything not in another lane
+        bulk        // Replies with ledger data, objects or transactions
+    };
+    static constexpr std::size_t sendLanes = 3;
+
 private:
     using clock_type = std::chrono::steady_clock;
     using error_code = boost::system::error_code;
@@ -155,7 +172,13 @@ private:
     http_request_type request_;
     http_response_type response_;
     boost::beast::http::fields const& headers_;
-    std::queue<std::shared_ptr<Message>> send_queue_;
+    // Messages waiting to be written, one queue per SendLane
+    std::array<std::deque<std::shared_ptr<Message>>, sendLanes> send_queue_;
+    // Messages taken from the send queue by the write in progress
+    std::vector<std::shared_ptr<Message>> writing_;
+    // Number of writes to the socket, and of messages they carried
+    std::atomic<std::uint64_t> writes_{0};
+    std::atomic<std::uint64_t> messagesWritten_{0};
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     std::unique_ptr<LoadEvent> load_event_;
@@ -173,6 +196,11 @@ private:
     // relayed. The hashes are sent once a second to a peer
     // and the peer requests missing transactions from the node.
     hash_set<uint256> txQueue_;
+    // Transactions relayed by this peer that were new to us, and ones we
+    // had already received. Both are halved once they add up to
+    // Tuning::txSourceWindow so that they follow the peer's recent behavior.
+    std::atomic<std::uint32_t> txFirst_{0};
+    std::atomic<std::uint32_t> txDuplicate_{0};
     // true if tx reduce-relay feature is enabled on the peer.
     bool txReduceRelayEnabled_ = false;
     // true if validation/proposal reduce-relay feature is enabled
@@ -181,6 +209,11 @@ private:
     bool ledgerReplayEnabled_ = false;
     LedgerReplayMsgHandler ledgerReplayMsgHandler_;
 
+    // The last ledger this peer asked us for, and the last one we loaded
+    // ahead of time for it
+    std::atomic<LedgerIndex> lastLedgerRequested_{0};
+    std::atomic<LedgerIndex> lastLedgerPrefetched_{0};
+
     friend class OverlayImpl;
 
     class Metrics
@@ -216,6 +249,16 @@ private:
         Metrics recv;
     } metrics_;
 
+    // Traffic with this peer, by category
+    TrafficCount traffic_;
+    // Round trip time of pings, and time taken to handle each message,
+    // including any job it queued
+    LatencyHistogram<std::chrono::milliseconds> rtt_;
+    LatencyHistogram<std::chrono::microseconds> processing_;
+    clock_type::time_point messageBegin_;
+    // Whether the message being read queued a job to handle it
+    bool messageJob_ = false;
+
 public:
     PeerImp(PeerImp const&) = delete;
     PeerImp&
@@ -293,6 +336,16 @@ public:
     void
     removeTxQueue(uint256 const& hash) override;
 
+    /** Return how many of every thousand transactions this peer relayed to
+        us were new to us.
+     */
+    std::uint32_t
+    txFirstShare() const;
+
+    /** Record whether a transaction relayed by this peer was new to us. */
+    void
+    countRelayedTx(bool first);
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <
         class FwdIt,
@@ -479,6 +532,19 @@ private:
     void
     onReadMessage(error_code ec, std::size_t bytes_transferred);
 
+    // Write as many queued messages as fit in one write
+    void
+    writeQueued();
+
+    /** Return the number of messages queued or being written. */
+    std::size_t
+    sendQueueSize() const;
+
+    /** Return true if the send queue is too long to take on the reply to
+        another request for data. */
+    bool
+    sendQueueFull() const;
+
     // Called when protocol messages bytes are sent
     void
     onWriteMessage(error_code ec, std::size_t bytes_transferred);
@@ -594,6 +660,21 @@ private:
         uint256 const& hash,
         std::lock_guard<std::mutex> const& lockedRecentLock);
 
+    /** Queue a job to finish handling the message being read.
+
+        The message's processing time is then measured until the job is
+        done, rather than until the message is dispatched.
+    */
+    void
+    addMessageJob(
+        JobType type,
+        std::string const& name,
+        std::function<void()> job);
+
+    // Record the time taken to handle a message that began at `begin`
+    void
+    recordProcessing(clock_type::time_point begin);
+
     void
     doFetchPack(const std::shared_ptr<protocol::TMGetObjectByHash>& packet);
 
@@ -642,6 +723,13 @@ private:
 
     void
     processLedgerRequest(std::shared_ptr<protocol::TMGetLedger> const& m);
+
+    /** Load the ledger after this one if the peer appears to be acquiring
+        consecutive ledgers, so that its next requests find the nodes they
+        need in memory.
+    */
+    void
+    prefetchNextLedger(std::shared_ptr<Ledger const> const& ledger);
 };
 
 //------------------------------------------------------------------------------
@@ -28,6 +28,8 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <google/protobuf/arena.h>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -263,6 +265,40 @@ parseMessageHeader(
     return std::nullopt;
 }
 
+/** Create an empty message to parse a message of the given size into.
+
+    A large message is backed by its own arena: the message, its
+    submessages and its repeated fields are all allocated from the arena,
+    which is freed in one piece when the last reference to the message
+    goes away. This replaces the many small allocations made while parsing
+    the message with a few large ones. Small messages don't allocate
+    enough to be worth an arena.
+
+    @param sizeHint The size of the serialized message.
+*/
+template <class T>
+std::shared_ptr<T>
+makeParseTarget(std::size_t sizeHint)
+{
+    std::size_t constexpr minArenaMessage = 2048;
+    if (sizeHint < minArenaMessage)
+        return std::make_shared<T>();
+
+    // The objects of a parsed message take about a third of its serialized
+    // size; the contents of bytes fields are allocated separately. The
+    // first block is sized to hold them, and later blocks grow from there.
+    std::size_t constexpr minBlock = 1024;
+    std::size_t constexpr maxBlock = megabytes(1);
+
+    ::google::protobuf::ArenaOptions options;
+    options.start_block_size = std::clamp(sizeHint / 3, minBlock, maxBlock);
+    options.max_block_size = maxBlock;
+
+    auto arena = std::make_shared<::google::protobuf::Arena>(options);
+    auto const m = ::google::protobuf::Arena::CreateMessage<T>(arena.get());
+    return std::shared_ptr<T>(std::move(arena), m);
+}
+
 template <
     class T,
     class Buffers,
@@ -271,7 +307,7 @@ template <
 std::shared_ptr<T>
 parseMessageContent(MessageHeader const& header, Buffers const& buffers)
 {
-    auto const m = std::make_shared<T>();
+    auto const m = makeParseTarget<T>(header.uncompressed_size);
 
     ZeroCopyInputStream<Buffers> stream(buffers);
     stream.Skip(header.header_size);
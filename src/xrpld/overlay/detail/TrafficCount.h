@@ -42,6 +42,10 @@ public:
         std::atomic<std::uint64_t> messagesIn{0};
         std::atomic<std::uint64_t> messagesOut{0};
 
+        // The same traffic before compression
+        std::atomic<std::uint64_t> rawBytesIn{0};
+        std::atomic<std::uint64_t> rawBytesOut{0};
+
         TrafficStats(char const* n) : name(n)
         {
         }
@@ -52,6 +56,8 @@ public:
             , bytesOut(ts.bytesOut.load())
             , messagesIn(ts.messagesIn.load())
             , messagesOut(ts.messagesOut.load())
+            , rawBytesIn(ts.rawBytesIn.load())
+            , rawBytesOut(ts.rawBytesOut.load())
         {
         }
 
@@ -71,6 +77,7 @@ public:
         overlay,    // overlay management
         manifests,  // manifest management
         transaction,
+        transaction_duplicate,  // subset of transaction already received
         proposal,
         validation,
         validatorlist,
@@ -168,20 +175,26 @@ public:
         int type,
         bool inbound);
 
-    /** Account for traffic associated with the given category */
+    /** Account for traffic associated with the given category
+
+        @param bytes The size of the message on the wire.
+        @param rawBytes The size of the message before compression.
+    */
     void
-    addCount(category cat, bool inbound, int bytes)
+    addCount(category cat, bool inbound, int bytes, int rawBytes)
     {
         assert(cat <= category::unknown);
 
         if (inbound)
         {
             counts_[cat].bytesIn += bytes;
+            counts_[cat].rawBytesIn += rawBytes;
             ++counts_[cat].messagesIn;
         }
         else
         {
             counts_[cat].bytesOut += bytes;
+            counts_[cat].rawBytesOut += rawBytes;
             ++counts_[cat].messagesOut;
         }
     }
@@ -205,6 +218,7 @@ protected:
         {"overhead_overlay"},   // category::overlay
         {"overhead_manifest"},  // category::manifests
         {"transactions"},       // category::transaction
+        {"transactions_duplicate"},  // category::transaction_duplicate
         {"proposals"},          // category::proposal
         {"validations"},        // category::validation
         {"validator_lists"},    // category::validatorlist
@@ -51,6 +51,10 @@ enum {
     /** How many messages we consider reasonable sustained on a send queue */
     targetSendQueue = 128,
 
+    /** How many replies to requests for ledger data, objects or transactions
+        may wait on a send queue before we refuse or drop more */
+    maxBulkSendQueue = 64,
+
     /** How often to log send queue size */
     sendQueueLogFreq = 64,
 
@@ -59,11 +63,26 @@ enum {
 
     /** The maximum number of levels to search */
     maxQueryDepth = 3,
+
+    /** How many nodes of the next ledger to load ahead of time for a peer
+        that is acquiring consecutive ledgers */
+    maxPrefetchNodes = 32768,
+
+    /** How many relayed transactions from a peer to consider when judging
+        how often it is the first to send us a transaction */
+    txSourceWindow = 1024,
+
+    /** Peers whose share of first transactions, in parts per thousand,
+        falls in the same bucket are treated alike when relaying */
+    txSourceBucket = 100,
 };
 
 /** Size of buffer used to read from the socket. */
 std::size_t constexpr readBufferBytes = 16384;
 
+/** Most bytes of queued messages to send in one write. */
+std::size_t constexpr sendQueueWriteBytes = 65536;
+
 }  // namespace Tuning
 
 }  // namespace ripple
@@ -75,6 +75,13 @@ TxMetrics::addMetrics(std::uint32_t missing)
     missingTx.addMetrics(missing);
 }
 
+void
+TxMetrics::addDuplicate(std::uint32_t val)
+{
+    std::lock_guard lock(mutex);
+    duplicateTx.addMetrics(val);
+}
+
 void
 MultipleMetrics::addMetrics(std::uint32_t val2)
 {
@@ -123,6 +130,12 @@ TxMetrics::json() const
     ret[jss::txr_tx_cnt] = std::to_string(tx.m1.rollingAvg);
     ret[jss::txr_tx_sz] = std::to_string(tx.m2.rollingAvg);
 
+    ret[jss::txr_duplicate_cnt] = std::to_string(duplicateTx.m1.rollingAvg);
+    ret[jss::txr_duplicate_sz] = std::to_string(duplicateTx.m2.rollingAvg);
+    ret[jss::txr_duplicate_pct] = std::to_string(
+        tx.m1.rollingAvg ? duplicateTx.m1.rollingAvg * 100 / tx.m1.rollingAvg
+                         : 0);
+
     ret[jss::txr_have_txs_cnt] = std::to_string(haveTx.m1.rollingAvg);
     ret[jss::txr_have_txs_sz] = std::to_string(haveTx.m2.rollingAvg);
 
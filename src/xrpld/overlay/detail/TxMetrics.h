@@ -90,6 +90,9 @@ struct TxMetrics
     mutable std::mutex mutex;
     // TMTransaction bytes and count per second
     MultipleMetrics tx;
+    // TMTransaction already received from another peer, bytes and count per
+    // second
+    MultipleMetrics duplicateTx;
     // TMHaveTransactions bytes and count per second
     MultipleMetrics haveTx;
     // TMGetLedger bytes and count per second
@@ -127,6 +130,11 @@ struct TxMetrics
      */
     void
     addMetrics(std::uint32_t missing);
+    /** Add a transaction that was already received from another peer
+       @param val message size in bytes
+     */
+    void
+    addDuplicate(std::uint32_t val);
     /** Get json representation of the metrics
        @return json object
      */
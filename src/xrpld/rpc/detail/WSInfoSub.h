@@ -67,6 +67,8 @@ public:
         return fwdfor_;
     }
 
+    using InfoSub::send;
+
     void
     send(Json::Value const& jv, bool) override
     {
@@ -81,6 +83,15 @@ public:
         auto m = std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(SharedJsonMessage const& msg, bool) override
+    {
+        auto sp = ws_.lock();
+        if (!sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(msg.text()));
+    }
 };
 
 }  // namespace ripple
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/main/Application.h>
 #include <xrpld/app/tx/detail/NFTokenUtils.h>
 #include <xrpld/ledger/ReadView.h>
@@ -193,6 +194,9 @@ doAccountObjects(RPC::JsonContext& context)
     if (ledger == nullptr)
         return result;
 
+    if (auto const stateIndex = context.app.getLedgerStateIndex())
+        ledger = stateIndex->view(ledger);
+
     auto const id = parseBase58<AccountID>(params[jss::account].asString());
     if (!id)
     {
@@ -17,7 +17,9 @@
 */
 //==============================================================================
 
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/ledger/LedgerToJson.h>
+#include <xrpld/app/main/Application.h>
 #include <xrpld/ledger/ReadView.h>
 #include <xrpld/rpc/Context.h>
 #include <xrpld/rpc/GRPCHandlers.h>
@@ -99,10 +101,13 @@ doLedgerData(RPC::JsonContext& context)
         nodes = Json::Value(Json::arrayValue);
     }
 
+    if (auto const stateIndex = context.app.getLedgerStateIndex())
+        lpLedger = stateIndex->view(lpLedger);
+
     auto e = lpLedger->sles.end();
     for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
     {
-        auto sle = lpLedger->read(keylet::unchecked((*i)->key()));
+        auto const sle = *i;
         if (limit-- <= 0)
         {
             // Stop processing before the current key.
@@ -156,6 +161,9 @@ doLedgerDataGrpc(
         return {response, errorStatus};
     }
 
+    if (auto const stateIndex = context.app.getLedgerStateIndex())
+        ledger = stateIndex->view(ledger);
+
     uint256 startKey;
     if (auto key = uint256::fromVoidChecked(request.marker()))
     {
@@ -184,7 +192,7 @@ doLedgerDataGrpc(
 
     for (auto i = ledger->sles.upper_bound(startKey); i != e; ++i)
     {
-        auto sle = ledger->read(keylet::unchecked((*i)->key()));
+        auto const sle = *i;
         if (maxLimit-- <= 0)
         {
             // Stop processing before the current key.
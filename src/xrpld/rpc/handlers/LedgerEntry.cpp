@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <xrpld/app/ledger/LedgerStateIndex.h>
 #include <xrpld/app/main/Application.h>
 #include <xrpld/ledger/ReadView.h>
 #include <xrpld/rpc/Context.h>
@@ -48,6 +49,9 @@ doLedgerEntry(RPC::JsonContext& context)
     if (!lpLedger)
         return jvResult;
 
+    if (auto const stateIndex = context.app.getLedgerStateIndex())
+        lpLedger = stateIndex->view(lpLedger);
+
     uint256 uNodeIndex;
     bool bNodeBinary = false;
     LedgerEntryType expectedType = ltANY;
@@ -33,7 +33,11 @@
 #include <xrpld/shamap/TreeNodeCache.h>
 #include <xrpl/basics/UnorderedContainers.h>
 #include <xrpl/beast/utility/Journal.h>
+#include <bitset>
 #include <cassert>
+#include <deque>
+#include <functional>
+#include <optional>
 #include <stack>
 #include <vector>
 
@@ -119,11 +123,22 @@ public:
     /** The depth of the hash map: data is only present in the leaves */
     static inline constexpr unsigned int leafDepth = 64;
 
+    /** Default number of inner nodes whose children are fetched together
+        by a prefetching traversal */
+    static inline constexpr std::size_t prefetchWindow = 32;
+
+    /** Number of modified grandchildren of the root above which the
+        branches of the root are flushed in parallel */
+    static inline constexpr int parallelFlushMin = 64;
+
     using DeltaItem = std::pair<
         boost::intrusive_ptr<SHAMapItem const>,
         boost::intrusive_ptr<SHAMapItem const>>;
     using Delta = std::map<uint256, DeltaItem>;
 
+    /** A set of the branches of the root node */
+    using RootBranches = std::bitset<branchFactor>;
+
     SHAMap() = delete;
     SHAMap(SHAMap const&) = delete;
     SHAMap&
@@ -164,6 +179,17 @@ public:
     const_iterator
     end() const;
 
+    /** Iterator to every node of a SHAMap, prefetching from the node store
+        This is always a const iterator.
+        Meets the requirements of InputIterator.
+    */
+    class prefetch_iterator;
+
+    prefetch_iterator
+    prefetch_begin(std::size_t window = prefetchWindow) const;
+    prefetch_iterator
+    prefetch_end() const;
+
     //--------------------------------------------------------------------------
 
     // Returns a new map that's a snapshot of this one.
@@ -264,6 +290,38 @@ public:
         std::function<
             void(boost::intrusive_ptr<SHAMapItem const> const&)> const&) const;
 
+    /**  Visit every node in this SHAMap, prefetching from the node store
+
+         Unlike visitNodes, the children of up to `window` inner nodes are
+         requested from the node store together before any of them is
+         visited. Nodes are visited one window at a time rather than in key
+         order, so use this only where the order does not matter.
+
+         @param function called with every node visited.
+         If function returns false, visitNodesPrefetch exits. It also exits
+         if the node store stops during the walk.
+         @param window the number of inner nodes whose children are fetched
+         in each round of reads.
+    */
+    void
+    visitNodesPrefetch(
+        std::function<bool(SHAMapTreeNode&)> const& function,
+        std::size_t window = prefetchWindow) const;
+
+    /**  Visit every leaf node in this SHAMap, prefetching from the node store
+
+         @param function called with every non inner node visited.
+         @param window the number of inner nodes whose children are fetched
+         in each round of reads.
+
+         @see visitNodesPrefetch
+    */
+    void
+    visitLeavesPrefetch(
+        std::function<void(
+            boost::intrusive_ptr<SHAMapItem const> const&)> const& function,
+        std::size_t window = prefetchWindow) const;
+
     // comparison/sync functions
 
     /** Check for nodes in the SHAMap not available
@@ -274,10 +332,16 @@ public:
 
         @param maxNodes The maximum number of found nodes to return
         @param filter The filter to use when retrieving nodes
+        @param branches The branches of the root to search. Searching
+                        only some of them lets disjoint parts of the map
+                        be requested from different peers.
         @param return The nodes known to be missing
     */
     std::vector<std::pair<SHAMapNodeID, uint256>>
-    getMissingNodes(int maxNodes, SHAMapSyncFilter* filter);
+    getMissingNodes(
+        int maxNodes,
+        SHAMapSyncFilter* filter,
+        RootBranches const& branches = RootBranches().set());
 
     bool
     getNodeFat(
@@ -323,6 +387,20 @@ public:
         Slice const& rawNode,
         SHAMapSyncFilter* filter);
 
+    /** Add a node already made by SHAMapTreeNode::makeFromWire.
+
+        Making a node deserializes and hashes it, which needs no lock on the
+        map, so the nodes of a large reply can be made in parallel before
+        they are added one at a time.
+
+        @param node The node, or nullptr if it could not be made.
+    */
+    SHAMapAddNode
+    addKnownNode(
+        SHAMapNodeID const& nodeID,
+        std::shared_ptr<SHAMapTreeNode> node,
+        SHAMapSyncFilter* filter);
+
     // status functions
     void
     setImmutable();
@@ -344,9 +422,13 @@ public:
     int
     unshare();
 
-    /** Flush modified nodes to the nodestore and convert them to shared. */
+    /** Flush modified nodes to the nodestore and convert them to shared.
+
+        @param parallel Whether the branches of the root may be flushed
+                        on several threads when many nodes were modified
+    */
     int
-    flushDirty(NodeObjectType t);
+    flushDirty(NodeObjectType t, bool parallel = true);
 
     void
     walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
@@ -482,6 +564,23 @@ private:
     std::shared_ptr<SHAMapTreeNode>
     descendNoStore(std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
+    /** Get the children of a group of inner nodes with one round of reads
+
+        Children that are not in memory or in the tree node cache are all
+        requested from the node store at once, and the call returns when
+        every read has completed. Like descendNoStore, the children are not
+        hooked to their parents.
+
+        @param parents the inner nodes whose children are wanted.
+        @return branchFactor entries per parent, in the order of `parents`.
+        Entries for empty branches and for nodes that could not be
+        retrieved are nullptr. If the node store stops before every read
+        has completed, nothing is returned.
+    */
+    std::optional<std::vector<std::shared_ptr<SHAMapTreeNode>>>
+    descendNoStore(
+        std::vector<std::shared_ptr<SHAMapInnerNode>> const& parents) const;
+
     /** If there is only one leaf below this node, get its contents */
     boost::intrusive_ptr<SHAMapItem const> const&
     onlyBelow(SHAMapTreeNode*) const;
@@ -503,7 +602,21 @@ private:
         Delta& differences,
         int& maxCount) const;
     int
-    walkSubTree(bool doWrite, NodeObjectType t);
+    walkSubTree(bool doWrite, NodeObjectType t, bool parallel = true);
+
+    // walkSubTree helpers
+    int
+    flushSubTree(
+        std::shared_ptr<SHAMapInnerNode>& node,
+        bool doWrite,
+        NodeObjectType t);
+    static int
+    dirtyBelowRoot(SHAMapInnerNode& root);
+    int
+    walkBranchesParallel(
+        SHAMapInnerNode& root,
+        bool doWrite,
+        NodeObjectType t);
 
     // Structure to track information about call to
     // getMissingNodes while it's in progress
@@ -517,6 +630,7 @@ private:
         // basic parameters
         int max_;
         SHAMapSyncFilter* filter_;
+        RootBranches const branches_;
         int const maxDefer_;
         std::uint32_t generation_;
 
@@ -558,10 +672,12 @@ private:
         MissingNodes(
             int max,
             SHAMapSyncFilter* filter,
+            RootBranches const& branches,
             int maxDefer,
             std::uint32_t generation)
             : max_(max)
             , filter_(filter)
+            , branches_(branches)
             , maxDefer_(maxDefer)
             , generation_(generation)
             , deferred_(0)
@@ -577,6 +693,13 @@ private:
     void
     gmn_ProcessDeferredReads(MissingNodes&);
 
+    // addKnownNode helper: makeNode is only called if the node is needed
+    SHAMapAddNode
+    addWireNode(
+        SHAMapNodeID const& nodeID,
+        std::function<std::shared_ptr<SHAMapTreeNode>()> const& makeNode,
+        SHAMapSyncFilter* filter);
+
     // fetch from DB helper function
     std::shared_ptr<SHAMapTreeNode>
     finishFetch(
@@ -754,6 +877,112 @@ SHAMap::end() const
     return const_iterator(this, nullptr);
 }
 
+//------------------------------------------------------------------------------
+
+/*  Nodes are visited one window at a time: the children of up to `window`
+    pending inner nodes are fetched together, queued for the caller, and any
+    inner children become pending in turn. Pending nodes are kept on a
+    stack, so the walk descends as it goes and the memory it needs stays
+    proportional to the window and the depth of the map rather than to the
+    width of its widest level.
+*/
+class SHAMap::prefetch_iterator
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = SHAMapTreeNode;
+    using reference = value_type&;
+    using pointer = value_type*;
+
+private:
+    SHAMap const* map_ = nullptr;
+    std::size_t window_ = 0;
+
+    // Nodes ready to be visited; the front is the current node
+    std::deque<std::shared_ptr<SHAMapTreeNode>> ready_;
+
+    // Inner nodes whose children have not been fetched yet
+    std::vector<std::shared_ptr<SHAMapInnerNode>> pending_;
+
+public:
+    prefetch_iterator() = delete;
+
+    prefetch_iterator(prefetch_iterator const& other) = default;
+    prefetch_iterator&
+    operator=(prefetch_iterator const& other) = default;
+
+    ~prefetch_iterator() = default;
+
+    reference
+    operator*() const;
+    pointer
+    operator->() const;
+
+    prefetch_iterator&
+    operator++();
+
+private:
+    prefetch_iterator(SHAMap const* map, std::size_t window);
+    explicit prefetch_iterator(SHAMap const* map);
+
+    // Fetch the children of the next window of pending inner nodes
+    void
+    fill();
+
+    friend bool
+    operator==(prefetch_iterator const& x, prefetch_iterator const& y);
+    friend class SHAMap;
+};
+
+inline SHAMap::prefetch_iterator::prefetch_iterator(SHAMap const* map)
+    : map_(map)
+{
+}
+
+inline SHAMap::prefetch_iterator::reference
+SHAMap::prefetch_iterator::operator*() const
+{
+    return *ready_.front();
+}
+
+inline SHAMap::prefetch_iterator::pointer
+SHAMap::prefetch_iterator::operator->() const
+{
+    return ready_.front().get();
+}
+
+inline bool
+operator==(
+    SHAMap::prefetch_iterator const& x,
+    SHAMap::prefetch_iterator const& y)
+{
+    assert(x.map_ == y.map_);
+    if (x.ready_.empty() || y.ready_.empty())
+        return x.ready_.empty() == y.ready_.empty();
+    return x.ready_.front() == y.ready_.front();
+}
+
+inline bool
+operator!=(
+    SHAMap::prefetch_iterator const& x,
+    SHAMap::prefetch_iterator const& y)
+{
+    return !(x == y);
+}
+
+inline SHAMap::prefetch_iterator
+SHAMap::prefetch_begin(std::size_t window) const
+{
+    return prefetch_iterator(this, window);
+}
+
+inline SHAMap::prefetch_iterator
+SHAMap::prefetch_end() const
+{
+    return prefetch_iterator(this);
+}
+
 }  // namespace ripple
 
 #endif
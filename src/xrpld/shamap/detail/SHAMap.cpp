@@ -25,6 +25,13 @@
 #include <xrpld/shamap/SHAMapTxPlusMetaLeafNode.h>
 #include <xrpl/basics/contract.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace ripple {
 
 [[nodiscard]] std::shared_ptr<SHAMapLeafNode>
@@ -353,6 +360,90 @@ SHAMap::descendNoStore(
     return ret;
 }
 
+std::optional<std::vector<std::shared_ptr<SHAMapTreeNode>>>
+SHAMap::descendNoStore(
+    std::vector<std::shared_ptr<SHAMapInnerNode>> const& parents) const
+{
+    std::vector<std::shared_ptr<SHAMapTreeNode>> children(
+        parents.size() * branchFactor);
+
+    // The reads complete on the node store's threads. Everything they touch
+    // is shared with them, since a read that is under way when the node
+    // store stops may complete after this function has given up on it.
+    struct Reads
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t pending = 0;
+        std::vector<std::shared_ptr<NodeObject>> objects;
+    };
+    auto reads = std::make_shared<Reads>();
+    std::vector<std::pair<std::size_t, SHAMapHash>> wanted;
+
+    for (std::size_t i = 0; i < parents.size(); ++i)
+    {
+        auto const& parent = parents[i];
+        for (unsigned branch = 0; branch < branchFactor; ++branch)
+        {
+            if (parent->isEmptyBranch(branch))
+                continue;
+
+            auto& child = children[i * branchFactor + branch];
+            child = parent->getChild(branch);
+            if (child || !backed_)
+                continue;
+
+            auto const& hash = parent->getChildHash(branch);
+            child = cacheLookup(hash);
+            if (!child)
+                wanted.emplace_back(i * branchFactor + branch, hash);
+        }
+    }
+
+    if (wanted.empty())
+        return children;
+
+    reads->pending = wanted.size();
+    reads->objects.resize(wanted.size());
+    for (std::size_t i = 0; i < wanted.size(); ++i)
+    {
+        f_.db().asyncFetch(
+            wanted[i].second.as_uint256(),
+            ledgerSeq_,
+            [reads, i](std::shared_ptr<NodeObject> const& object) {
+                std::lock_guard lock(reads->mutex);
+                reads->objects[i] = object;
+                if (--reads->pending == 0)
+                    reads->cv.notify_all();
+            });
+    }
+
+    {
+        using namespace std::chrono_literals;
+        std::unique_lock lock(reads->mutex);
+        while (!reads->cv.wait_for(
+            lock, 100ms, [&reads]() { return reads->pending == 0; }))
+        {
+            // Reads that are still queued are dropped when the node store
+            // stops. Their nodes are not known to be missing.
+            if (f_.db().isStopping())
+                return std::nullopt;
+        }
+    }
+
+    for (std::size_t i = 0; i < wanted.size(); ++i)
+    {
+        std::shared_ptr<NodeObject> object;
+        {
+            std::lock_guard lock(reads->mutex);
+            object = std::move(reads->objects[i]);
+        }
+        children[wanted[i].first] = finishFetch(wanted[i].second, object);
+    }
+
+    return children;
+}
+
 std::pair<SHAMapTreeNode*, SHAMapNodeID>
 SHAMap::descend(
     SHAMapInnerNode* parent,
@@ -989,14 +1080,14 @@ SHAMap::unshare()
 }
 
 int
-SHAMap::flushDirty(NodeObjectType t)
+SHAMap::flushDirty(NodeObjectType t, bool parallel)
 {
     // We only write back if this map is backed.
-    return walkSubTree(backed_, t);
+    return walkSubTree(backed_, t, parallel);
 }
 
 int
-SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
+SHAMap::walkSubTree(bool doWrite, NodeObjectType t, bool parallel)
 {
     assert(!doWrite || backed_);
 
@@ -1025,13 +1116,32 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         return 1;
     }
 
+    node = preFlushNode(std::move(node));
+
+    if (parallel && dirtyBelowRoot(*node) >= parallelFlushMin)
+        flushed += walkBranchesParallel(*node, doWrite, t);
+
+    flushed += flushSubTree(node, doWrite, t);
+
+    // Last inner node is the new root_
+    root_ = std::move(node);
+
+    return flushed;
+}
+
+int
+SHAMap::flushSubTree(
+    std::shared_ptr<SHAMapInnerNode>& node,
+    bool doWrite,
+    NodeObjectType t)
+{
+    int flushed = 0;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair<std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
-    node = preFlushNode(std::move(node));
-
     int pos = 0;
 
     // We can't flush an inner node until we flush its children
@@ -1114,8 +1224,99 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move(node);
+    return flushed;
+}
+
+int
+SHAMap::dirtyBelowRoot(SHAMapInnerNode& root)
+{
+    int dirty = 0;
+    for (unsigned i = 0; i < branchFactor; ++i)
+    {
+        auto const child = root.getChildPointer(i);
+        if (!child || child->cowid() == 0 || !child->isInner())
+            continue;
+
+        auto const inner = static_cast<SHAMapInnerNode*>(child);
+        for (unsigned j = 0; j < branchFactor; ++j)
+        {
+            auto const grandchild = inner->getChildPointer(j);
+            if (grandchild && grandchild->cowid() != 0)
+                ++dirty;
+        }
+    }
+    return dirty;
+}
+
+int
+SHAMap::walkBranchesParallel(
+    SHAMapInnerNode& root,
+    bool doWrite,
+    NodeObjectType t)
+{
+    assert(root.cowid() == cowid_);
+
+    // The modified inner children of the root head independent subtrees
+    std::array<std::shared_ptr<SHAMapInnerNode>, branchFactor> branches;
+    std::size_t count = 0;
+    for (unsigned i = 0; i < branchFactor; ++i)
+    {
+        if (root.isEmptyBranch(i))
+            continue;
+
+        auto child = root.getChild(i);
+        if (child && child->cowid() != 0 && child->isInner())
+        {
+            branches[i] = std::static_pointer_cast<SHAMapInnerNode>(
+                preFlushNode(std::move(child)));
+            ++count;
+        }
+    }
+
+    std::atomic<unsigned> next{0};
+    std::atomic<int> flushed{0};
+    std::mutex m;
+    std::exception_ptr error;
+
+    auto work = [&]() {
+        try
+        {
+            for (unsigned i = next++; i < branchFactor; i = next++)
+            {
+                if (branches[i])
+                    flushed += flushSubTree(branches[i], doWrite, t);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard l(m);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    // Threads take the next unflushed branch as they finish one, so a
+    // large branch doesn't hold up the others
+    auto const threads = std::min<std::size_t>(
+        count, std::max(std::thread::hardware_concurrency(), 1u));
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+        worker.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    // The branches can now be shared, so flushing the root skips them
+    for (unsigned i = 0; i < branchFactor; ++i)
+    {
+        if (branches[i])
+            root.shareChild(i, branches[i]);
+    }
 
     return flushed;
 }
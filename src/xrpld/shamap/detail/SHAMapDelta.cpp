@@ -20,7 +20,9 @@
 #include <xrpld/shamap/SHAMap.h>
 #include <xrpl/basics/contract.h>
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <stack>
 #include <vector>
 
@@ -239,33 +241,46 @@ SHAMap::walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
     if (!root_->isInner())  // root_ is only node, and we have it
         return;
 
-    using StackEntry = std::shared_ptr<SHAMapInnerNode>;
-    std::stack<StackEntry, std::vector<StackEntry>> nodeStack;
-
-    nodeStack.push(std::static_pointer_cast<SHAMapInnerNode>(root_));
+    // Inner nodes still to be walked. The children of a whole window of
+    // them are read from the node store together, so a walk over a map
+    // that is mostly on disk is not bound by the latency of each read.
+    std::vector<std::shared_ptr<SHAMapInnerNode>> pending;
+    pending.push_back(std::static_pointer_cast<SHAMapInnerNode>(root_));
 
-    while (!nodeStack.empty())
+    while (!pending.empty())
     {
-        std::shared_ptr<SHAMapInnerNode> node = std::move(nodeStack.top());
-        nodeStack.pop();
-
-        for (int i = 0; i < 16; ++i)
+        auto const first = pending.end() -
+            std::min<std::ptrdiff_t>(prefetchWindow, pending.size());
+        std::vector<std::shared_ptr<SHAMapInnerNode>> parents(
+            std::make_move_iterator(first),
+            std::make_move_iterator(pending.end()));
+        pending.erase(first, pending.end());
+
+        // Stop the walk if the node store is stopping, without reporting
+        // the nodes it didn't read as missing
+        auto const children = descendNoStore(parents);
+        if (!children)
+            return;
+
+        for (std::size_t i = 0; i < parents.size(); ++i)
         {
-            if (!node->isEmptyBranch(i))
+            for (unsigned branch = 0; branch < branchFactor; ++branch)
             {
-                std::shared_ptr<SHAMapTreeNode> nextNode =
-                    descendNoStore(node, i);
+                if (parents[i]->isEmptyBranch(branch))
+                    continue;
 
-                if (nextNode)
+                if (auto const& nextNode =
+                        (*children)[i * branchFactor + branch])
                 {
                     if (nextNode->isInner())
-                        nodeStack.push(
+                        pending.push_back(
                             std::static_pointer_cast<SHAMapInnerNode>(
                                 nextNode));
                 }
                 else
                 {
-                    missingNodes.emplace_back(type_, node->getChildHash(i));
+                    missingNodes.emplace_back(
+                        type_, parents[i]->getChildHash(branch));
                     if (--maxMissing <= 0)
                         return;
                 }
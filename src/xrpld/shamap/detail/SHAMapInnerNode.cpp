@@ -132,21 +132,25 @@ SHAMapInnerNode::makeFullInner(
     if (data.size() != branchFactor * uint256::bytes)
         Throw<std::runtime_error>("Invalid FI node");
 
-    auto ret = std::make_shared<SHAMapInnerNode>(0, branchFactor);
-
-    SerialIter si(data);
-
-    auto hashes = ret->hashesAndChildren_.getHashes();
-
+    // Find the branches first, so the child arrays are allocated once at
+    // their final size.
+    std::uint16_t isBranch = 0;
     for (int i = 0; i < branchFactor; ++i)
     {
-        hashes[i].as_uint256() = si.getBitString<256>();
-
-        if (hashes[i].isNonZero())
-            ret->isBranch_ |= (1 << i);
+        auto const h = data.data() + i * uint256::bytes;
+        if (std::any_of(h, h + uint256::bytes, [](auto b) { return b != 0; }))
+            isBranch |= (1 << i);
     }
 
-    ret->resizeChildArrays(ret->getBranchCount());
+    auto ret = std::make_shared<SHAMapInnerNode>(0, popcnt16(isBranch));
+    ret->isBranch_ = isBranch;
+
+    auto hashes = ret->hashesAndChildren_.getHashes();
+
+    ret->iterNonEmptyChildIndexes([&](auto branchNum, auto indexNum) {
+        hashes[indexNum].as_uint256() =
+            uint256::fromVoid(data.data() + branchNum * uint256::bytes);
+    });
 
     if (hashValid)
         ret->hash_ = hash;
@@ -19,8 +19,12 @@
 
 #include <xrpld/shamap/SHAMap.h>
 #include <xrpld/shamap/SHAMapSyncFilter.h>
+#include <xrpl/basics/contract.h>
 #include <xrpl/basics/random.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace ripple {
 
 void
@@ -96,6 +100,98 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     }
 }
 
+void
+SHAMap::visitNodesPrefetch(
+    std::function<bool(SHAMapTreeNode&)> const& function,
+    std::size_t window) const
+{
+    for (auto it = prefetch_begin(window); it != prefetch_end(); ++it)
+    {
+        if (!function(*it))
+            return;
+    }
+}
+
+void
+SHAMap::visitLeavesPrefetch(
+    std::function<void(boost::intrusive_ptr<SHAMapItem const> const&
+                           item)> const& leafFunction,
+    std::size_t window) const
+{
+    visitNodesPrefetch(
+        [&leafFunction](SHAMapTreeNode& node) {
+            if (!node.isInner())
+                leafFunction(static_cast<SHAMapLeafNode&>(node).peekItem());
+            return true;
+        },
+        window);
+}
+
+SHAMap::prefetch_iterator::prefetch_iterator(
+    SHAMap const* map,
+    std::size_t window)
+    : map_(map), window_(std::max<std::size_t>(window, 1))
+{
+    assert(map_ != nullptr);
+
+    if (!map_->root_)
+        return;
+
+    ready_.push_back(map_->root_);
+    if (map_->root_->isInner())
+        pending_.push_back(
+            std::static_pointer_cast<SHAMapInnerNode>(map_->root_));
+}
+
+SHAMap::prefetch_iterator&
+SHAMap::prefetch_iterator::operator++()
+{
+    ready_.pop_front();
+    while (ready_.empty() && !pending_.empty())
+        fill();
+    return *this;
+}
+
+void
+SHAMap::prefetch_iterator::fill()
+{
+    auto const first =
+        pending_.end() - std::min<std::ptrdiff_t>(window_, pending_.size());
+    std::vector<std::shared_ptr<SHAMapInnerNode>> parents(
+        std::make_move_iterator(first),
+        std::make_move_iterator(pending_.end()));
+    pending_.erase(first, pending_.end());
+
+    // If the node store is stopping, end the walk rather than report the
+    // nodes it didn't read as missing
+    auto const children = map_->descendNoStore(parents);
+    if (!children)
+    {
+        ready_.clear();
+        pending_.clear();
+        return;
+    }
+
+    for (std::size_t i = 0; i < parents.size(); ++i)
+    {
+        for (unsigned branch = 0; branch < branchFactor; ++branch)
+        {
+            if (parents[i]->isEmptyBranch(branch))
+                continue;
+
+            auto const& child = (*children)[i * branchFactor + branch];
+            if (!child)
+                Throw<SHAMapMissingNode>(
+                    map_->type_, parents[i]->getChildHash(branch));
+
+            if (child->isInner())
+                pending_.push_back(
+                    std::static_pointer_cast<SHAMapInnerNode>(child));
+            ready_.push_back(child);
+        }
+    }
+}
+
 void
 SHAMap::visitDifferences(
     SHAMap const* have,
@@ -183,6 +279,14 @@ SHAMap::gmn_ProcessNodes(MissingNodes& mn, MissingNodes::StackEntry& se)
         if (node->isEmptyBranch(branch))
             continue;
 
+        if (nodeID.isRoot() && !mn.branches_[branch])
+        {
+            // Another search covers this branch, so we can't tell
+            // whether anything is missing below it
+            fullBelow = false;
+            continue;
+        }
+
         auto const& childHash = node->getChildHash(branch);
 
         if (mn.missingHashes_.count(childHash) != 0)
@@ -314,7 +418,10 @@ SHAMap::gmn_ProcessDeferredReads(MissingNodes& mn)
     nodes that are not permanently stored locally
 */
 std::vector<std::pair<SHAMapNodeID, uint256>>
-SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
+SHAMap::getMissingNodes(
+    int max,
+    SHAMapSyncFilter* filter,
+    RootBranches const& branches)
 {
     assert(root_->getHash().isNonZero());
     assert(max > 0);
@@ -322,6 +429,7 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
     MissingNodes mn(
         max,
         filter,
+        branches,
         512,  // number of async reads per pass
         f_.getFullBelowCache(ledgerSeq_)->getGeneration());
 
@@ -417,7 +525,7 @@ SHAMap::getMissingNodes(int max, SHAMapSyncFilter* filter)
 
     } while (node != nullptr);
 
-    if (mn.missingNodes_.empty())
+    if (mn.missingNodes_.empty() && branches.all())
         clearSynching();
 
     return std::move(mn.missingNodes_);
@@ -571,6 +679,26 @@ SHAMap::addKnownNode(
     const SHAMapNodeID& node,
     Slice const& rawNode,
     SHAMapSyncFilter* filter)
+{
+    return addWireNode(
+        node, [&]() { return SHAMapTreeNode::makeFromWire(rawNode); }, filter);
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode(
+    SHAMapNodeID const& node,
+    std::shared_ptr<SHAMapTreeNode> newNode,
+    SHAMapSyncFilter* filter)
+{
+    return addWireNode(
+        node, [&newNode]() { return std::move(newNode); }, filter);
+}
+
+SHAMapAddNode
+SHAMap::addWireNode(
+    SHAMapNodeID const& node,
+    std::function<std::shared_ptr<SHAMapTreeNode>()> const& makeNode,
+    SHAMapSyncFilter* filter)
 {
     assert(!node.isRoot());
 
@@ -609,7 +737,7 @@ SHAMap::addKnownNode(
 
         if (iNode == nullptr)
         {
-            auto newNode = SHAMapTreeNode::makeFromWire(rawNode);
+            auto newNode = makeNode();
 
             if (!newNode || childHash != newNode->getHash())
             {